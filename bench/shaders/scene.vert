@@ -0,0 +1,30 @@
+#version 450
+
+layout(location = 0) in vec3 in_point;
+layout(location = 1) in vec3 in_color;
+layout(location = 2) in vec2 in_texture;
+
+layout(location = 0) out vec3 out_color;
+layout(location = 1) out vec2 out_texture;
+
+layout(binding = 0) uniform Matrices {
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+} matrices;
+
+layout(push_constant) uniform Grid {
+    uint columns;
+    float spacing;
+    float scale;
+} grid;
+
+void main() {
+    // instances are placed on a square grid centered at the origin
+    vec2 cell = vec2(gl_InstanceIndex % grid.columns, gl_InstanceIndex / grid.columns);
+    vec2 offset = (cell - 0.5 * float(grid.columns - 1)) * grid.spacing;
+    vec4 point = matrices.model * vec4(in_point * grid.scale, 1);
+    gl_Position = matrices.proj * matrices.view * (point + vec4(offset, 0, 0));
+    out_color = in_color;
+    out_texture = in_texture;
+}
@@ -0,0 +1,18 @@
+#version 450
+#extension GL_EXT_nonuniform_qualifier : require
+
+layout(location = 0) in vec3 in_color;
+layout(location = 1) in vec2 in_texture;
+
+layout(location = 0) out vec4 out_color;
+
+// the array of the bindless table, the index is the same for the whole draw
+layout(set = 1, binding = 0) uniform sampler2D textures[];
+
+layout(push_constant) uniform Material {
+    layout(offset = 12) uint texture_index;
+} material;
+
+void main() {
+    out_color = vec4(in_color, 1) * texture(textures[material.texture_index], in_texture);
+}
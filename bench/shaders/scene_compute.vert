@@ -0,0 +1,32 @@
+#version 450
+
+layout(location = 0) in vec3 in_point;
+layout(location = 1) in vec3 in_color;
+layout(location = 2) in vec2 in_texture;
+
+layout(location = 0) out vec3 out_color;
+layout(location = 1) out vec2 out_texture;
+
+layout(binding = 0) uniform Matrices {
+    mat4 model;
+    mat4 view;
+    mat4 proj;
+} matrices;
+
+// written by the compute pass of the frame
+layout(binding = 2) readonly buffer Offsets {
+    vec4 offsets[];
+};
+
+layout(push_constant) uniform Grid {
+    uint columns;
+    float spacing;
+    float scale;
+} grid;
+
+void main() {
+    vec4 point = matrices.model * vec4(in_point * grid.scale, 1);
+    gl_Position = matrices.proj * matrices.view * (point + offsets[gl_InstanceIndex]);
+    out_color = in_color;
+    out_texture = in_texture;
+}
@@ -0,0 +1,113 @@
+#include "bench_options.hpp"
+
+#include "utility/error.hpp"
+
+#include <charconv>
+#include <string_view>
+
+namespace {
+
+    template <typename T>
+    T parse_number(std::string_view option, std::string_view value) {
+        T number{};
+        auto [end, error] = std::from_chars(value.data(), value.data() + value.size(), number);
+        if (error != std::errc{} || end != value.data() + value.size()) {
+            raise_error("Invalid value {} of the option {}.", value, option);
+        }
+        return number;
+    }
+
+    std::vector<std::string> split(std::string_view value, char delimiter) {
+        std::vector<std::string> parts;
+        while (!value.empty()) {
+            size_t pos = value.find(delimiter);
+            parts.emplace_back(value.substr(0, pos));
+            value = pos == std::string_view::npos ? std::string_view{} : value.substr(pos + 1);
+        }
+        return parts;
+    }
+
+} // namespace
+
+BenchOptions BenchOptions::parse(int argc, char **argv) {
+    BenchOptions options;
+    for (int i = 1; i < argc; ++i) {
+        std::string_view option = argv[i];
+        if (option == "--headless") {
+            options.headless = true;
+            continue;
+        }
+        if (i + 1 == argc) {
+            raise_error("Missing value of the option {}.", option);
+        }
+        std::string_view value = argv[++i];
+        if (option == "--scenes") {
+            options.scenes = split(value, ',');
+        } else if (option == "--frames") {
+            options.frames = parse_number<uint32_t>(option, value);
+        } else if (option == "--warmup") {
+            options.warmup_frames = parse_number<uint32_t>(option, value);
+        } else if (option == "--instances") {
+            options.instances = parse_number<uint32_t>(option, value);
+        } else if (option == "--textures") {
+            options.textures = parse_number<uint32_t>(option, value);
+        } else if (option == "--texture-size") {
+            options.texture_size = parse_number<uint32_t>(option, value);
+        } else if (option == "--frames-in-flight") {
+            options.frames_in_flight = parse_number<uint32_t>(option, value);
+        } else if (option == "--width") {
+            options.width = parse_number<int>(option, value);
+        } else if (option == "--height") {
+            options.height = parse_number<int>(option, value);
+        } else if (option == "--output") {
+            options.output = value;
+        } else if (option == "--trace") {
+            options.trace = value;
+        } else {
+            raise_error("Unknown option {}.", option);
+        }
+    }
+    if (options.frames == 0 || options.instances == 0 || options.textures == 0 || options.texture_size == 0) {
+        raise_error("Frames, instances, textures and texture size must be positive.");
+    }
+    return options;
+}
+
+std::string BenchOptions::get_usage() {
+    return "Usage: vkengine_bench [options]\n"
+           "  --scenes <list>          comma separated scenes: plain, instanced, textured, bindless, compute\n"
+           "  --frames <count>         measured frames per scene\n"
+           "  --warmup <count>         frames rendered before the measurement\n"
+           "  --instances <count>      instances of the mesh in the instanced and compute scenes\n"
+           "  --textures <count>       textures in the textured and bindless scenes\n"
+           "  --texture-size <pixels>  size of the generated textures\n"
+           "  --frames-in-flight <n>   frames in flight\n"
+           "  --width <pixels>         width of the window or the offscreen images\n"
+           "  --height <pixels>        height of the window or the offscreen images\n"
+           "  --headless               render without a window\n"
+           "  --output <file>          JSON report file, standard output by default\n"
+           "  --trace <file>           chrome trace file of the instrumented zones\n";
+}
+
+SceneConfig BenchOptions::get_scene_config(std::string const &name) const {
+    if (name == "plain") {
+        return SceneConfig{.name = name};
+    }
+    if (name == "instanced") {
+        return SceneConfig{.name = name, .instances_count = instances};
+    }
+    if (name == "textured") {
+        // every texture is bound to a separate descriptor set and drawn by a separate call
+        return SceneConfig{.name = name, .draws_count = textures, .textures_count = textures, .texture_size = texture_size};
+    }
+    if (name == "bindless") {
+        // the same draws as the textured scene with a single descriptor set bind
+        return SceneConfig{
+            .name = name, .draws_count = textures, .textures_count = textures, .texture_size = texture_size, .bindless = true};
+    }
+    if (name == "compute") {
+        // the instances of the instanced scene are placed by a compute pass every frame
+        return SceneConfig{.name = name, .instances_count = instances, .compute = true};
+    }
+    raise_error("Unknown scene {}.", name);
+}
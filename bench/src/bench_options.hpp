@@ -0,0 +1,40 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct SceneConfig {
+    std::string name;
+    uint32_t draws_count = 1;
+    // instances drawn by a single draw call
+    uint32_t instances_count = 1;
+    uint32_t textures_count = 1;
+    uint32_t texture_size = 256;
+    // the textures are indexed in the bindless table instead of being bound by their own sets
+    bool bindless = false;
+    // the offsets of the instances are written by the compute queue before the draws
+    bool compute = false;
+};
+
+struct BenchOptions {
+    std::vector<std::string> scenes{"plain", "instanced", "textured"};
+    uint32_t frames = 1000;
+    uint32_t warmup_frames = 100;
+    uint32_t instances = 1024;
+    uint32_t textures = 64;
+    uint32_t texture_size = 512;
+    uint32_t frames_in_flight = 2;
+    int width = 1280;
+    int height = 720;
+    bool headless = false;
+    std::string output;
+    // chrome trace of the instrumented zones, written when the engine is built with tracing
+    std::string trace;
+
+    static BenchOptions parse(int argc, char **argv);
+
+    static std::string get_usage();
+
+    SceneConfig get_scene_config(std::string const &name) const;
+};
@@ -0,0 +1,85 @@
+#include "bench_report.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <numeric>
+
+namespace {
+
+    // nearest rank percentile of the sorted values
+    double percentile(std::vector<double> const &sorted, double rank) {
+        if (sorted.empty()) {
+            return 0.0;
+        }
+        size_t index = static_cast<size_t>(std::ceil(rank / 100.0 * sorted.size()));
+        return sorted[std::clamp<size_t>(index, 1, sorted.size()) - 1];
+    }
+
+    std::string quoted(std::string const &value) {
+        std::string result{'"'};
+        for (char c : value) {
+            if (c == '"' || c == '\\') {
+                result.push_back('\\');
+            }
+            result.push_back(c);
+        }
+        result.push_back('"');
+        return result;
+    }
+
+    void write_timings(std::ostream &stream, char const *name, std::vector<double> values, char const *indent) {
+        std::sort(values.begin(), values.end());
+        double mean = values.empty() ? 0.0 : std::accumulate(values.begin(), values.end(), 0.0) / values.size();
+        stream << indent << quoted(name) << ": {";
+        if (values.empty()) {
+            stream << "\"samples\": 0},\n";
+            return;
+        }
+        stream << "\"samples\": " << values.size() << ", \"mean\": " << mean << ", \"min\": " << values.front()
+               << ", \"p50\": " << percentile(values, 50) << ", \"p95\": " << percentile(values, 95)
+               << ", \"p99\": " << percentile(values, 99) << ", \"max\": " << values.back() << "},\n";
+    }
+
+} // namespace
+
+void BenchReport::write_json(std::ostream &stream) const {
+    stream << "{\n";
+    stream << "  \"device\": " << quoted(device_name) << ",\n";
+    stream << "  \"driver_version\": " << quoted(driver_version) << ",\n";
+    stream << "  \"headless\": " << (options.headless ? "true" : "false") << ",\n";
+    stream << "  \"width\": " << options.width << ",\n";
+    stream << "  \"height\": " << options.height << ",\n";
+    stream << "  \"frames_in_flight\": " << options.frames_in_flight << ",\n";
+    stream << "  \"scenes\": [\n";
+    for (size_t i = 0; i < results.size(); ++i) {
+        SceneResult const &result = results[i];
+        stream << "    {\n";
+        stream << "      \"name\": " << quoted(result.scene.name) << ",\n";
+        stream << "      \"draws\": " << result.scene.draws_count << ",\n";
+        stream << "      \"instances_per_draw\": " << result.scene.instances_count << ",\n";
+        stream << "      \"textures\": " << result.scene.textures_count << ",\n";
+        stream << "      \"texture_size\": " << result.scene.texture_size << ",\n";
+        stream << "      \"frames\": " << result.cpu_frame_times.size() << ",\n";
+        stream << "      \"seconds\": " << result.total_seconds << ",\n";
+        write_timings(stream, "cpu_frame_ms", result.cpu_frame_times, "      ");
+        write_timings(stream, "gpu_frame_ms", result.gpu_frame_times, "      ");
+        stream << "      \"submits\": {\"frames\": " << result.frame_submits << ", \"uploads\": " << result.upload_submits << "},\n";
+        stream << "      \"memory\": {\"allocations\": " << result.allocator.allocations_count
+               << ", \"deallocations\": " << result.allocator.deallocations_count
+               << ", \"device_memory_objects\": " << result.allocator.device_memory_count
+               << ", \"device_memory_bytes\": " << result.allocator.device_memory_size
+               << ", \"used_bytes\": " << result.allocator.used_size << "},\n";
+        stream << "      \"pipeline_statistics\": ";
+        if (auto const &statistics = result.pipeline_statistics) {
+            stream << "{\"input_vertices\": " << statistics->input_vertices << ", \"vertex_invocations\": " << statistics->vertex_invocations
+                   << ", \"clipping_invocations\": " << statistics->clipping_invocations
+                   << ", \"clipping_primitives\": " << statistics->clipping_primitives
+                   << ", \"fragment_invocations\": " << statistics->fragment_invocations << "}\n";
+        } else {
+            stream << "null\n";
+        }
+        stream << "    }" << (i + 1 < results.size() ? "," : "") << '\n';
+    }
+    stream << "  ]\n";
+    stream << "}\n";
+}
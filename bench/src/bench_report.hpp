@@ -0,0 +1,33 @@
+#pragma once
+
+#include "bench_options.hpp"
+
+#include "graphics/allocator_interface.hpp"
+#include "graphics/query_pool.hpp"
+
+#include <optional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+struct SceneResult {
+    SceneConfig scene;
+    // milliseconds of the measured frames
+    std::vector<double> cpu_frame_times;
+    std::vector<double> gpu_frame_times;
+    double total_seconds = 0.0;
+    uint64_t frame_submits = 0;
+    uint64_t upload_submits = 0;
+    AllocatorStatistics allocator;
+    // empty when the device does not support pipeline statistics queries
+    std::optional<PipelineStatistics> pipeline_statistics;
+};
+
+struct BenchReport {
+    std::string device_name;
+    std::string driver_version;
+    BenchOptions options;
+    std::vector<SceneResult> results;
+
+    void write_json(std::ostream &stream) const;
+};
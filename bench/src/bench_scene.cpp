@@ -0,0 +1,275 @@
+#include "bench_scene.hpp"
+
+#include "embedded_shaders.hpp"
+
+#include "graphics/compute_pipeline_builder.hpp"
+#include "graphics/dispatch_command.hpp"
+
+#include "utility/error.hpp"
+
+#include <array>
+#include <cmath>
+
+namespace {
+
+    constexpr char const *zone_name = "scene";
+
+    // set of the bindless table following the set of the matrix
+    constexpr uint32_t bindless_set = 1;
+
+    // binding of the offsets in the sets of the compute and the vertex shaders
+    constexpr uint32_t offsets_binding = 2;
+
+    // push constants of the compute shader
+    struct Wave {
+        uint32_t columns;
+        float spacing;
+        float time;
+        uint32_t count;
+    };
+
+} // namespace
+
+BenchScene::BenchScene(GraphicsRenderer &renderer, SceneConfig const &config)
+    : config_{config}
+    , renderer_{renderer}
+    , allocator_{renderer.get_allocator()}
+    , deleter_{renderer.get_deleter()}
+    , transfer_{renderer.get_device_context().get_device(), renderer.get_device_context().get_transfer_qfm(), 0}
+    , barrier_{renderer.get_device_context().get_device(), renderer.get_device_context().get_graphics_qfm(), 0}
+    , mesh_{renderer.get_device_context().get_device(), allocator_, transfer_}
+    , matrix_{std::make_shared<MatrixDescriptor>(renderer.get_device_context().get_device())}
+    , bindless_table_{config.bindless ? renderer.get_bindless_table() : nullptr}
+    , vertex_shader_{renderer.get_shader_library().get_shader(
+          config.compute ? embedded_shaders::scene_compute_vert : embedded_shaders::scene_vert, VK_SHADER_STAGE_VERTEX_BIT)}
+    , fragment_shader_{renderer.get_shader_library().get_shader(
+          config.bindless ? embedded_shaders::scene_bindless_frag : embedded_shaders::scene_frag, VK_SHADER_STAGE_FRAGMENT_BIT)}
+    , builder_{renderer.get_device_context().get_device(), renderer.get_device_context().get_pipeline_cache()}
+    , gpu_profiler_{renderer.get_gpu_profiler()}
+    , start_time_{std::chrono::steady_clock::now()} {
+    auto device = renderer.get_device_context().get_device();
+    auto &layout_cache = renderer.get_layout_cache();
+    ShaderLayout shader_layout{&vertex_shader_.get_reflection(), &fragment_shader_.get_reflection()};
+    if (config_.bindless && !bindless_table_) {
+        raise_error("Bindless scene requires descriptor indexing.");
+    }
+    uint32_t instances_count = config_.draws_count * config_.instances_count;
+    if (config_.compute) {
+        if (!renderer.get_compute_queue()) {
+            raise_error("Compute scene requires timeline semaphores.");
+        }
+        offsets_size_ = sizeof(float) * 4 * instances_count;
+        setup_offset_buffer(1);
+    }
+    textures_.reserve(config_.textures_count);
+    descriptor_sets_.reserve(bindless_table_ ? 1 : config_.textures_count);
+    for (uint32_t i = 0; i < config_.textures_count; ++i) {
+        auto texture = std::make_shared<CheckerTexture>(device, allocator_, transfer_, barrier_, config_.texture_size, i);
+        textures_.push_back(texture);
+        if (bindless_table_) {
+            texture_indices_.push_back(bindless_table_->register_texture(texture->get_texture()));
+            continue;
+        }
+        std::vector<std::shared_ptr<DescriptorInterface>> descriptors{matrix_, texture};
+        if (offsets_) {
+            descriptors.push_back(offsets_);
+        }
+        descriptor_sets_.emplace_back(device, shader_layout, 0, layout_cache, descriptors, renderer.get_descriptor_allocator());
+    }
+    builder_.set_shader_stages({&vertex_shader_, &fragment_shader_});
+    if (bindless_table_) {
+        // the only set of the scene holds the matrix while the textures are indexed in the table bound once
+        descriptor_sets_.emplace_back(device,
+                                      shader_layout,
+                                      0,
+                                      layout_cache,
+                                      std::vector<std::shared_ptr<DescriptorInterface>>{matrix_},
+                                      renderer.get_descriptor_allocator());
+        std::initializer_list<LayoutCache::ExternalSet> external_sets{{bindless_set, bindless_table_->get_layout()}};
+        pipeline_layout_ = layout_cache.get_pipeline_layout(shader_layout, external_sets);
+        builder_.set_shader_layout(shader_layout, layout_cache, external_sets);
+    } else {
+        // the descriptor sets share the cached set layout of the pipeline layout, the push constants are reflected as well
+        pipeline_layout_ = layout_cache.get_pipeline_layout(shader_layout);
+        builder_.set_shader_layout(shader_layout, layout_cache);
+    }
+    for (auto const &range : shader_layout.get_push_constant_ranges()) {
+        push_constant_stages_ |= range.stageFlags;
+    }
+    builder_.set_depth_stencil_state(VkPipelineDepthStencilStateCreateInfo{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO,
+        .depthTestEnable = VK_TRUE,
+        .depthWriteEnable = VK_TRUE,
+        .depthCompareOp = VK_COMPARE_OP_LESS,
+        .depthBoundsTestEnable = VK_FALSE,
+        .stencilTestEnable = VK_FALSE,
+        .front = {},
+        .back = {},
+        .minDepthBounds = 0,
+        .maxDepthBounds = 1,
+    });
+    uint32_t columns = static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<double>(instances_count))));
+    grid_ = Grid{
+        .columns = columns,
+        .spacing = 1.0f / columns,
+        .scale = 0.8f / columns,
+    };
+    if (config_.compute) {
+        auto compute_shader =
+            renderer.get_shader_library().get_shader(embedded_shaders::scene_offsets_comp, VK_SHADER_STAGE_COMPUTE_BIT);
+        ShaderLayout compute_layout{&compute_shader.get_reflection()};
+        ComputePipelineBuilder compute_builder{device, renderer.get_device_context().get_pipeline_cache()};
+        compute_builder.set_shader(compute_shader);
+        compute_builder.set_shader_layout(compute_layout, layout_cache);
+        compute_layout_ = layout_cache.get_pipeline_layout(compute_layout);
+        compute_pipeline_ = compute_builder.make_pipeline();
+        compute_groups_ = DispatchCommand::get_groups_count(instances_count, compute_builder.get_local_size()[0]);
+        compute_set_.emplace(device,
+                             compute_layout,
+                             0,
+                             layout_cache,
+                             std::vector<std::shared_ptr<DescriptorInterface>>{offsets_},
+                             renderer.get_descriptor_allocator());
+    }
+}
+
+BenchScene::~BenchScene() {
+    // the slots are freed after the frames which may sample the textures
+    for (uint32_t index : texture_indices_) {
+        bindless_table_->release_image(index);
+    }
+}
+
+void BenchScene::setup_pipeline(GraphicsRenderer::Context const &info) {
+    matrix_->setup_buffers(info.images_count, info.surface_extent, allocator_);
+    if (compute_set_) {
+        setup_offset_buffer(info.images_count);
+        compute_set_->set_swapchain_images_count(info.images_count);
+    }
+    for (auto &descriptor_set : descriptor_sets_) {
+        descriptor_set.set_swapchain_images_count(info.images_count);
+    }
+    // viewport and scissor are dynamic so the pipeline is rebuilt only for a new render pass
+    if (pipeline_ && render_pass_ == info.render_pass) {
+        return;
+    }
+    render_pass_ = info.render_pass;
+    builder_.set_render_pass(info.render_pass, info.render_pass_key);
+    deleter_->retire(std::move(pipeline_));
+    pipeline_ = builder_.make_pipeline();
+}
+
+void BenchScene::update_command_buffer(VkCommandBuffer command_buffer, size_t image_index) {
+    GpuProfiler::ScopedZone zone{gpu_profiler_, command_buffer, zone_name};
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_.get());
+    vkCmdPushConstants(command_buffer, pipeline_layout_.get(), push_constant_stages_, 0, sizeof(Grid), &grid_);
+    if (bindless_table_) {
+        VkDescriptorSet descriptor_sets[] = {
+            descriptor_sets_.front().get_descriptor_set(image_index),
+            bindless_table_->get_descriptor_set(),
+        };
+        vkCmdBindDescriptorSets(
+            command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout_.get(), 0, 2, descriptor_sets, 0, nullptr);
+    }
+    for (uint32_t i = 0; i < config_.draws_count; ++i) {
+        if (bindless_table_) {
+            uint32_t texture_index = texture_indices_[i % texture_indices_.size()];
+            vkCmdPushConstants(command_buffer,
+                               pipeline_layout_.get(),
+                               push_constant_stages_,
+                               sizeof(Grid),
+                               sizeof(texture_index),
+                               &texture_index);
+        } else {
+            VkDescriptorSet descriptor_set = descriptor_sets_[i % descriptor_sets_.size()].get_descriptor_set(image_index);
+            vkCmdBindDescriptorSets(
+                command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_layout_.get(), 0, 1, &descriptor_set, 0, nullptr);
+        }
+        mesh_.draw(command_buffer, config_.instances_count, i * config_.instances_count);
+    }
+}
+
+std::optional<double> BenchScene::update_image(size_t image_index) {
+    matrix_->update_content(image_index);
+    if (compute_pipeline_) {
+        // the sets of the image are not used by the pending frames so the replaced offsets are written now
+        bool updated = false;
+        for (auto &descriptor_set : descriptor_sets_) {
+            updated = descriptor_set.update(image_index) || updated;
+        }
+        if (updated) {
+            // the command buffer of the image is recorded again after the callback
+            renderer_.update_commands();
+        }
+        compute_set_->update(image_index);
+        dispatch_offsets(image_index);
+    }
+    auto statistics = gpu_profiler_.get_zone_statistics(GpuProfiler::frame_zone);
+    if (!statistics || statistics->samples == gpu_samples_) {
+        return std::nullopt;
+    }
+    gpu_samples_ = statistics->samples;
+    return statistics->last;
+}
+
+std::optional<PipelineStatistics> BenchScene::get_pipeline_statistics() const {
+    auto statistics = gpu_profiler_.get_zone_statistics(zone_name);
+    if (!statistics) {
+        return std::nullopt;
+    }
+    return statistics->pipeline_statistics;
+}
+
+void BenchScene::setup_offset_buffer(uint32_t images_count) {
+    if (images_count <= offset_slices_) {
+        return;
+    }
+    auto const &device_context = renderer_.get_device_context();
+    VkDeviceSize alignment = device_context.get_properties().limits.minStorageBufferOffsetAlignment;
+    VkDeviceSize stride = (offsets_size_ + alignment - 1) / alignment * alignment;
+    // the buffer written by the async compute queue is read by the graphics one without the ownership transfers
+    std::array<uint32_t, 2> qfm_indices{device_context.get_graphics_qfm(), device_context.get_compute_qfm()};
+    VkSharingMode mode = renderer_.get_compute_queue()->is_async() ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+    // the pending frames still read the old buffer
+    deleter_->retire(std::move(offset_buffer_));
+    offset_buffer_ = MemoryBuffer(device_context.get_device(),
+                                  allocator_,
+                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT,
+                                  stride * images_count,
+                                  VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                  mode,
+                                  qfm_indices);
+    offset_slices_ = images_count;
+    std::vector<VkDescriptorBufferInfo> buffer_infos(images_count);
+    for (uint32_t i = 0; i < images_count; ++i) {
+        buffer_infos[i] = VkDescriptorBufferInfo{
+            .buffer = offset_buffer_.get_buffer(),
+            .offset = i * stride,
+            .range = offsets_size_,
+        };
+    }
+    offsets_ = std::make_shared<StorageBufferDescriptor>(
+        offsets_binding, VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT, std::move(buffer_infos));
+    // the sets of the new images are written at once while the others are written again by the updates of their frames
+    for (auto &descriptor_set : descriptor_sets_) {
+        descriptor_set.set_descriptor(offsets_);
+    }
+    if (compute_set_) {
+        compute_set_->set_descriptor(offsets_);
+    }
+}
+
+void BenchScene::dispatch_offsets(size_t image_index) {
+    // the draws of the image have completed so its slice may be written again
+    auto command = std::make_unique<DispatchCommand>(compute_pipeline_.get(), compute_layout_.get(), compute_groups_);
+    command->set_descriptor_sets({compute_set_->get_descriptor_set(image_index)});
+    command->set_push_constants(Wave{
+        .columns = grid_.columns,
+        .spacing = grid_.spacing,
+        .time = std::chrono::duration<float>(std::chrono::steady_clock::now() - start_time_).count(),
+        .count = config_.draws_count * config_.instances_count,
+    });
+    renderer_.get_compute_queue()->add_command(std::move(command));
+    // the draws of the frame wait for the offsets on the vertex stages
+    renderer_.submit_compute();
+}
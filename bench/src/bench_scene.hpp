@@ -0,0 +1,90 @@
+#pragma once
+
+#include "bench_options.hpp"
+#include "checker_texture.hpp"
+#include "matrix_descriptor.hpp"
+#include "plain_mesh.hpp"
+
+#include "graphics/descriptor_set.hpp"
+#include "graphics/graphics_renderer.hpp"
+#include "graphics/memory_buffer.hpp"
+#include "graphics/pipeline_builder.hpp"
+#include "graphics/shader_context.hpp"
+#include "graphics/storage_buffer_descriptor.hpp"
+
+#include <chrono>
+#include <optional>
+
+class BenchScene {
+    struct Grid {
+        uint32_t columns;
+        float spacing;
+        float scale;
+    };
+
+    SceneConfig config_;
+    GraphicsRenderer &renderer_;
+    std::shared_ptr<AllocatorInterface> allocator_;
+    std::shared_ptr<DeferredDeleter> deleter_;
+    Commander transfer_;
+    Commander barrier_;
+    PlainMesh mesh_;
+    std::shared_ptr<MatrixDescriptor> matrix_;
+    std::vector<std::shared_ptr<CheckerTexture>> textures_;
+    // every texture is bound by its own descriptor set unless the scene is bindless
+    std::vector<DescriptorSet> descriptor_sets_;
+    BindlessTable *bindless_table_ = nullptr;
+    // indices of the textures in the bindless table pushed before every draw
+    std::vector<uint32_t> texture_indices_;
+    ShaderContext vertex_shader_;
+    ShaderContext fragment_shader_;
+    shared_ptr_of<VkPipelineLayout> pipeline_layout_;
+    // the range is shared by the stages so it's pushed with all of them
+    VkShaderStageFlags push_constant_stages_ = 0;
+    PipelineBuilder builder_;
+    unique_ptr_of<VkPipeline> pipeline_;
+    VkRenderPass render_pass_ = nullptr;
+    GpuProfiler &gpu_profiler_;
+    // samples count of the frame zone when the last GPU time was reported
+    uint64_t gpu_samples_ = 0;
+    Grid grid_;
+    // offsets of the instances written by the compute pass and read by the draws of the same image, the pipeline,
+    // the sets and the buffer live until the renderer has waited for the device
+    MemoryBuffer offset_buffer_;
+    // the images use the aligned slices of the buffer which is recreated when the swapchain gains images
+    uint32_t offset_slices_ = 0;
+    VkDeviceSize offsets_size_ = 0;
+    std::shared_ptr<StorageBufferDescriptor> offsets_;
+    std::optional<DescriptorSet> compute_set_;
+    shared_ptr_of<VkPipelineLayout> compute_layout_;
+    unique_ptr_of<VkPipeline> compute_pipeline_;
+    uint32_t compute_groups_ = 0;
+    std::chrono::steady_clock::time_point start_time_;
+
+    void setup_offset_buffer(uint32_t images_count);
+
+    void dispatch_offsets(size_t image_index);
+
+  public:
+    BenchScene(GraphicsRenderer &renderer, SceneConfig const &config);
+
+    ~BenchScene();
+
+    void setup_pipeline(GraphicsRenderer::Context const &info);
+
+    void update_command_buffer(VkCommandBuffer command_buffer, size_t image_index);
+
+    // dispatches the compute pass of the image, returns GPU milliseconds of the last frame measured by the profiler
+    std::optional<double> update_image(size_t image_index);
+
+    size_t get_upload_submits() const {
+        return transfer_.get_submits_count() + barrier_.get_submits_count();
+    }
+
+    bool is_gpu_time_supported() const {
+        return gpu_profiler_.is_enabled();
+    }
+
+    // shader invocations of the last measured frame
+    std::optional<PipelineStatistics> get_pipeline_statistics() const;
+};
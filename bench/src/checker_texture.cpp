@@ -0,0 +1,104 @@
+#include "checker_texture.hpp"
+
+#include "graphics/image_copy_command.hpp"
+#include "graphics/image_transition_command.hpp"
+#include "graphics/memory_barrier.hpp"
+#include "graphics/memory_buffer.hpp"
+
+#include <algorithm>
+#include <vector>
+
+namespace {
+
+    constexpr uint32_t cells_count = 8;
+
+    std::vector<uint32_t> make_pixels(uint32_t size, uint32_t seed) {
+        // the color of the cells depends on the seed so the textures differ
+        uint32_t color = 0xff000000 | ((seed * 2654435761u) & 0x00ffffff);
+        uint32_t cell_size = std::max(size / cells_count, 1u);
+        std::vector<uint32_t> pixels(static_cast<size_t>(size) * size);
+        for (uint32_t y = 0; y < size; ++y) {
+            for (uint32_t x = 0; x < size; ++x) {
+                bool odd = ((x / cell_size) + (y / cell_size)) % 2 != 0;
+                pixels[static_cast<size_t>(y) * size + x] = odd ? color : 0xffffffff;
+            }
+        }
+        return pixels;
+    }
+
+} // namespace
+
+CheckerTexture::CheckerTexture(shared_ptr_of<VkDevice> device,
+                               std::shared_ptr<AllocatorInterface> allocator,
+                               Commander &transfer,
+                               Commander &barrier,
+                               uint32_t size,
+                               uint32_t seed) {
+    auto pixels = make_pixels(size, seed);
+    size_t data_size = pixels.size() * sizeof(uint32_t);
+    texture_ = ImageTexture(device, allocator, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, size, size);
+    MemoryBuffer buffer(device,
+                        allocator,
+                        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                        data_size,
+                        VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    buffer.fill(pixels.data(), data_size);
+    transfer.add_command(
+        std::make_unique<ImageTransitionCommand>(VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                                 VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                                 MemoryBarrier::make_image_barrier(texture_.get_image(),
+                                                                                   VK_IMAGE_ASPECT_COLOR_BIT,
+                                                                                   MemoryBarrier::ImageInfo{
+                                                                                       .access_mask = 0,
+                                                                                       .layout = VK_IMAGE_LAYOUT_UNDEFINED,
+                                                                                   },
+                                                                                   MemoryBarrier::ImageInfo{
+                                                                                       .access_mask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                                                                                       .layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                                                   })));
+    transfer.add_command(std::make_unique<ImageCopyCommand>(buffer.get_buffer(), texture_.get_image(), size, size));
+    transfer.execute();
+    barrier.add_command(
+        std::make_unique<ImageTransitionCommand>(VK_PIPELINE_STAGE_TRANSFER_BIT,
+                                                 VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+                                                 MemoryBarrier::make_image_barrier(texture_.get_image(),
+                                                                                   VK_IMAGE_ASPECT_COLOR_BIT,
+                                                                                   MemoryBarrier::ImageInfo{
+                                                                                       .access_mask = VK_ACCESS_TRANSFER_WRITE_BIT,
+                                                                                       .layout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                                                                                   },
+                                                                                   MemoryBarrier::ImageInfo{
+                                                                                       .access_mask = VK_ACCESS_SHADER_READ_BIT,
+                                                                                       .layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+                                                                                   })));
+    barrier.execute();
+    image_info_ = VkDescriptorImageInfo{
+        .sampler = texture_.get_sampler(),
+        .imageView = texture_.get_image_view(),
+        .imageLayout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL,
+    };
+}
+
+VkDescriptorSetLayoutBinding CheckerTexture::get_binding() const {
+    return VkDescriptorSetLayoutBinding{
+        .binding = 1,
+        .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        .descriptorCount = 1,
+        .stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT,
+        .pImmutableSamplers = nullptr,
+    };
+}
+
+VkWriteDescriptorSet CheckerTexture::get_write(VkDescriptorSet descriptor_set, size_t /* image_index */) const {
+    return VkWriteDescriptorSet{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = descriptor_set,
+        .dstBinding = 1,
+        .dstArrayElement = 0,
+        .descriptorCount = 1,
+        .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        .pImageInfo = &image_info_,
+        .pBufferInfo = nullptr,
+        .pTexelBufferView = nullptr,
+    };
+}
@@ -0,0 +1,28 @@
+#pragma once
+
+#include "graphics/allocator_interface.hpp"
+#include "graphics/commander.hpp"
+#include "graphics/descriptor_interface.hpp"
+#include "graphics/image_texture.hpp"
+
+// generated texture so the benchmark does not depend on image files
+class CheckerTexture : public DescriptorInterface {
+    ImageTexture texture_;
+    VkDescriptorImageInfo image_info_;
+
+  public:
+    CheckerTexture(shared_ptr_of<VkDevice> device,
+                   std::shared_ptr<AllocatorInterface> allocator,
+                   Commander &transfer,
+                   Commander &barrier,
+                   uint32_t size,
+                   uint32_t seed);
+
+    ImageTexture const &get_texture() const {
+        return texture_;
+    }
+
+    VkDescriptorSetLayoutBinding get_binding() const override;
+
+    VkWriteDescriptorSet get_write(VkDescriptorSet descriptor_set, size_t image_index) const override;
+};
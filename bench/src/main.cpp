@@ -0,0 +1,109 @@
+#include "bench_options.hpp"
+#include "bench_report.hpp"
+#include "bench_scene.hpp"
+
+#include "utility/error.hpp"
+#include "utility/trace.hpp"
+
+#include <chrono>
+#include <cstring>
+#include <fstream>
+#include <iostream>
+
+namespace {
+
+    using bench_clock = std::chrono::steady_clock;
+
+    double to_milliseconds(bench_clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    SceneResult run_scene(BenchOptions const &options, SceneConfig const &config, BenchReport &report) {
+        GraphicsRenderer renderer{WindowConfig{
+                                      .title = "vkengine benchmark",
+                                      .width = options.width,
+                                      .height = options.height,
+                                      .headless = options.headless,
+                                  },
+                                  GraphicsRenderer::Config{
+                                      // frames are not limited by the vertical synchronization
+                                      .desired_present_mode = VK_PRESENT_MODE_IMMEDIATE_KHR,
+                                      .depth_buffering = true,
+                                      .frames_in_flight = options.frames_in_flight,
+                                      .max_queued_presents = 0,
+                                      .gpu_profiling = true,
+                                  }};
+        auto const &properties = renderer.get_device_context().get_properties();
+        report.device_name = properties.deviceName;
+        report.driver_version = std::to_string(properties.driverVersion);
+
+        BenchScene scene(renderer, config);
+        SceneResult result{.scene = config};
+        result.cpu_frame_times.reserve(options.frames);
+        result.gpu_frame_times.reserve(options.frames);
+        uint32_t frame = 0;
+        uint64_t first_submit = 0;
+        bench_clock::time_point start_time, frame_time;
+        renderer.set_context_changed_callback([&scene](GraphicsRenderer::Context const &context) { scene.setup_pipeline(context); });
+        renderer.set_update_command_callback(
+            [&scene](VkCommandBuffer command_buffer, size_t image_index) { scene.update_command_buffer(command_buffer, image_index); });
+        renderer.set_update_frame_callback([&](size_t /* frame_index */, size_t image_index) {
+            auto gpu_time = scene.update_image(image_index);
+            auto now = bench_clock::now();
+            // the intervals between the frames after the warmup are measured
+            if (frame == options.warmup_frames) {
+                start_time = now;
+                first_submit = renderer.get_submitted_frames();
+            } else if (frame > options.warmup_frames) {
+                result.cpu_frame_times.push_back(to_milliseconds(now - frame_time));
+                if (gpu_time) {
+                    result.gpu_frame_times.push_back(*gpu_time);
+                }
+            }
+            frame_time = now;
+            if (++frame > options.warmup_frames + options.frames) {
+                renderer.stop();
+            }
+        });
+        renderer.run();
+        result.total_seconds = std::chrono::duration<double>(frame_time - start_time).count();
+        result.frame_submits = renderer.get_submitted_frames() - first_submit;
+        result.upload_submits = scene.get_upload_submits();
+        result.allocator = renderer.get_allocator()->get_statistics();
+        result.pipeline_statistics = scene.get_pipeline_statistics();
+        return result;
+    }
+
+} // namespace
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; ++i) {
+        if (std::strcmp(argv[i], "--help") == 0) {
+            std::cout << BenchOptions::get_usage();
+            return 0;
+        }
+    }
+    try {
+        BenchReport report{.options = BenchOptions::parse(argc, argv)};
+        trace_thread_name("main");
+        for (auto const &scene : report.options.scenes) {
+            report.results.push_back(run_scene(report.options, report.options.get_scene_config(scene), report));
+        }
+        if (report.options.output.empty()) {
+            report.write_json(std::cout);
+        } else {
+            std::ofstream file(report.options.output);
+            if (!file) {
+                raise_error("Failed to open the report file {}.", report.options.output);
+            }
+            report.write_json(file);
+        }
+        if (!report.options.trace.empty()) {
+            TraceProvider::save_chrome_trace(report.options.trace);
+        }
+    } catch (std::exception const &ex) {
+        std::cerr << ex.what() << '\n' << BenchOptions::get_usage();
+        return 1;
+    }
+    return 0;
+}
@@ -1,6 +1,7 @@
 #include "mesh_reader.hpp"
 
 #include "utility/error.hpp"
+#include "utility/trace.hpp"
 
 #include <fstream>
 #include <unordered_map>
@@ -66,6 +67,7 @@ std::istream &operator>>(std::istream &is, glm::vec2 &v) {
 }
 
 Mesh<Vertex, uint32_t> MeshReader::read_blender(std::string_view filename) {
+    trace_zone("MeshReader::read_blender");
     std::ifstream ifs{filename.data()};
     if (!ifs.is_open()) {
         raise_error("Failed to open file {}", filename);
@@ -2,6 +2,16 @@
 
 #include "memory_block.hpp"
 
+struct AllocatorStatistics {
+    uint64_t allocations_count = 0;
+    uint64_t deallocations_count = 0;
+    // device memory objects allocated from the driver
+    uint64_t device_memory_count = 0;
+    VkDeviceSize device_memory_size = 0;
+    // memory occupied by the allocated blocks
+    VkDeviceSize used_size = 0;
+};
+
 class AllocatorInterface {
   public:
     virtual ~AllocatorInterface() = default;
@@ -9,4 +19,6 @@ class AllocatorInterface {
     virtual MemoryBlock allocate(VkMemoryRequirements const &requirements, VkMemoryAllocateFlags flags) = 0;
 
     virtual void deallocate(MemoryBlock const &block) = 0;
+
+    virtual AllocatorStatistics get_statistics() const = 0;
 };
@@ -0,0 +1,160 @@
+#include "bindless_table.hpp"
+
+#include "graphics_error.hpp"
+#include "graphics_manager.hpp"
+
+#include <algorithm>
+#include <array>
+
+class BindlessTable::SlotReleaser {
+    std::shared_ptr<Slots> slots_;
+    uint32_t binding_;
+    uint32_t index_;
+
+  public:
+    SlotReleaser(std::shared_ptr<Slots> slots, uint32_t binding, uint32_t index)
+        : slots_{std::move(slots)}
+        , binding_{binding}
+        , index_{index} {
+    }
+
+    SlotReleaser(SlotReleaser &&) noexcept = default;
+
+    ~SlotReleaser() {
+        if (slots_) {
+            std::lock_guard lock{slots_->mutex};
+            (binding_ == images_binding ? slots_->free_images : slots_->free_buffers).push_back(index_);
+        }
+    }
+};
+
+BindlessTable::BindlessTable(DeviceContext const &device_context,
+                             std::shared_ptr<DeferredDeleter> deleter,
+                             uint32_t images_count,
+                             uint32_t buffers_count)
+    : device_{device_context.get_device()}
+    , deleter_{std::move(deleter)}
+    , slots_{std::make_shared<Slots>()} {
+    if (!is_supported(device_context)) {
+        raise_error("Bindless table requires descriptor indexing.");
+    }
+    VkPhysicalDeviceVulkan12Properties limits{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_PROPERTIES};
+    VkPhysicalDeviceProperties2 properties{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2, .pNext = &limits};
+    vkGetPhysicalDeviceProperties2(device_context.get_physical_device(), &properties);
+    images_count_ = std::max(1u,
+                             std::min({images_count,
+                                       limits.maxPerStageDescriptorUpdateAfterBindSampledImages,
+                                       limits.maxPerStageDescriptorUpdateAfterBindSamplers,
+                                       limits.maxDescriptorSetUpdateAfterBindSampledImages}));
+    buffers_count_ = std::max(1u,
+                              std::min({buffers_count,
+                                        limits.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+                                        limits.maxDescriptorSetUpdateAfterBindStorageBuffers}));
+    info_println("Bindless table of {} images and {} buffers", images_count_, buffers_count_);
+
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{
+        VkDescriptorSetLayoutBinding{
+            .binding = images_binding,
+            .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+            .descriptorCount = images_count_,
+            .stageFlags = VK_SHADER_STAGE_ALL,
+            .pImmutableSamplers = nullptr,
+        },
+        VkDescriptorSetLayoutBinding{
+            .binding = buffers_binding,
+            .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+            .descriptorCount = buffers_count_,
+            .stageFlags = VK_SHADER_STAGE_ALL,
+            .pImmutableSamplers = nullptr,
+        },
+    };
+    // the unused elements are never written and the used ones are written while the set is bound
+    VkDescriptorBindingFlags constexpr binding_flags =
+        VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT | VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT;
+    std::array<VkDescriptorBindingFlags, 2> flags{binding_flags, binding_flags};
+    set_layout_ = GraphicsManager::make_descriptor_set_layout(
+        device_, bindings, VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT, flags);
+
+    std::array<VkDescriptorPoolSize, 2> pool_sizes{
+        VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .descriptorCount = images_count_},
+        VkDescriptorPoolSize{.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .descriptorCount = buffers_count_},
+    };
+    descriptor_pool_ = GraphicsManager::make_descriptor_pool(device_, 1, pool_sizes, VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT);
+    VkDescriptorSetLayout set_layout = set_layout_.get();
+    descriptor_set_ = GraphicsManager::allocate_descriptor_sets(device_, descriptor_pool_.get(), std::span(&set_layout, 1)).front();
+}
+
+bool BindlessTable::is_supported(DeviceContext const &device_context) {
+    auto const &features = device_context.get_features().vulkan12;
+    return features.runtimeDescriptorArray == VK_TRUE && features.descriptorBindingPartiallyBound == VK_TRUE &&
+           features.descriptorBindingSampledImageUpdateAfterBind == VK_TRUE &&
+           features.descriptorBindingStorageBufferUpdateAfterBind == VK_TRUE;
+}
+
+uint32_t BindlessTable::acquire_slot(std::vector<uint32_t> &free_slots, uint32_t &next_slot, uint32_t count, char const *name) {
+    if (!free_slots.empty()) {
+        uint32_t index = free_slots.back();
+        free_slots.pop_back();
+        return index;
+    }
+    if (next_slot == count) {
+        raise_error("Bindless table is out of {} slots, there are {}.", name, count);
+    }
+    return next_slot++;
+}
+
+void BindlessTable::write(VkWriteDescriptorSet const &write) const {
+    vkUpdateDescriptorSets(device_.get(), 1, &write, 0, nullptr);
+}
+
+uint32_t BindlessTable::register_image(VkImageView image_view, VkSampler sampler, VkImageLayout image_layout) {
+    std::lock_guard lock{slots_->mutex};
+    uint32_t index = acquire_slot(slots_->free_images, next_image_, images_count_, "image");
+    VkDescriptorImageInfo image_info{
+        .sampler = sampler,
+        .imageView = image_view,
+        .imageLayout = image_layout,
+    };
+    write(VkWriteDescriptorSet{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = descriptor_set_,
+        .dstBinding = images_binding,
+        .dstArrayElement = index,
+        .descriptorCount = 1,
+        .descriptorType = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER,
+        .pImageInfo = &image_info,
+        .pBufferInfo = nullptr,
+        .pTexelBufferView = nullptr,
+    });
+    return index;
+}
+
+uint32_t BindlessTable::register_buffer(VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range) {
+    std::lock_guard lock{slots_->mutex};
+    uint32_t index = acquire_slot(slots_->free_buffers, next_buffer_, buffers_count_, "buffer");
+    VkDescriptorBufferInfo buffer_info{
+        .buffer = buffer,
+        .offset = offset,
+        .range = range,
+    };
+    write(VkWriteDescriptorSet{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = descriptor_set_,
+        .dstBinding = buffers_binding,
+        .dstArrayElement = index,
+        .descriptorCount = 1,
+        .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .pImageInfo = nullptr,
+        .pBufferInfo = &buffer_info,
+        .pTexelBufferView = nullptr,
+    });
+    return index;
+}
+
+void BindlessTable::release_image(uint32_t index) {
+    deleter_->retire(SlotReleaser{slots_, images_binding, index});
+}
+
+void BindlessTable::release_buffer(uint32_t index) {
+    deleter_->retire(SlotReleaser{slots_, buffers_binding, index});
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include "deferred_deleter.hpp"
+#include "device_context.hpp"
+#include "image_texture.hpp"
+
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// single descriptor set with the arrays of all the textures and storage buffers which the shaders index by the
+// numbers passed through the push constants, so the materials don't need their own sets
+class BindlessTable {
+  public:
+    static constexpr uint32_t images_binding = 0;
+    static constexpr uint32_t buffers_binding = 1;
+
+  private:
+    // the indices are returned once the frames which may use them have been completed
+    struct Slots {
+        std::mutex mutex;
+        std::vector<uint32_t> free_images;
+        std::vector<uint32_t> free_buffers;
+    };
+
+    class SlotReleaser;
+
+    shared_ptr_of<VkDevice> device_;
+    std::shared_ptr<DeferredDeleter> deleter_;
+    uint32_t images_count_;
+    uint32_t buffers_count_;
+    shared_ptr_of<VkDescriptorSetLayout> set_layout_;
+    unique_ptr_of<VkDescriptorPool> descriptor_pool_;
+    VkDescriptorSet descriptor_set_;
+    std::shared_ptr<Slots> slots_;
+    uint32_t next_image_ = 0;
+    uint32_t next_buffer_ = 0;
+
+    uint32_t acquire_slot(std::vector<uint32_t> &free_slots, uint32_t &next_slot, uint32_t count, char const *name);
+
+    void write(VkWriteDescriptorSet const &write) const;
+
+  public:
+    // the counts are clamped to the limits of the device
+    BindlessTable(DeviceContext const &device_context,
+                  std::shared_ptr<DeferredDeleter> deleter,
+                  uint32_t images_count,
+                  uint32_t buffers_count);
+
+    // requires the descriptor indexing features of Vulkan 1.2
+    static bool is_supported(DeviceContext const &device_context);
+
+    // the index is stable until the image is released, may be called from any thread
+    uint32_t register_image(VkImageView image_view,
+                            VkSampler sampler,
+                            VkImageLayout image_layout = VK_IMAGE_LAYOUT_SHADER_READ_ONLY_OPTIMAL);
+
+    uint32_t register_texture(ImageTexture const &texture) {
+        return register_image(texture.get_image_view(), texture.get_sampler());
+    }
+
+    uint32_t register_buffer(VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+
+    // the index is reused after the frames submitted so far have been completed
+    void release_image(uint32_t index);
+
+    void release_buffer(uint32_t index);
+
+    // bound once per frame, the descriptors may be updated while it's bound
+    VkDescriptorSet get_descriptor_set() const {
+        return descriptor_set_;
+    }
+
+    VkDescriptorSetLayout get_layout() const {
+        return set_layout_.get();
+    }
+
+    uint32_t get_images_count() const {
+        return images_count_;
+    }
+
+    uint32_t get_buffers_count() const {
+        return buffers_count_;
+    }
+};
@@ -3,6 +3,8 @@
 #include "graphics/graphics_error.hpp"
 #include "graphics/graphics_manager.hpp"
 
+#include "utility/trace.hpp"
+
 unique_ptr_of<VkCommandBuffer> Commander::begin_command() {
     auto command_buffer = GraphicsManager::make_command_buffer(device_, command_pool_);
     VkCommandBufferBeginInfo begin_info{
@@ -22,7 +24,9 @@ void Commander::end_command(VkCommandBuffer command_buffer) {
         .pCommandBuffers = &command_buffer,
     };
     vkQueueSubmit(queue_, 1, &submit_info, nullptr);
+    trace_zone("wait_queue_idle");
     vkQueueWaitIdle(queue_);
+    ++submits_count_;
 }
 
 Commander::Commander(shared_ptr_of<VkDevice> device, uint32_t qfm_index, uint32_t queue_index)
@@ -45,6 +49,8 @@ void Commander::execute() {
     if (commands_.empty()) {
         return;
     }
+    trace_zone("Commander::execute");
+    trace_counter("commands", commands_.size());
     auto command_buffer = begin_command();
     for (auto &command : commands_) {
         command->execute(command_buffer.get());
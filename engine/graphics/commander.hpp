@@ -9,6 +9,7 @@ class Commander {
     shared_ptr_of<VkCommandPool> command_pool_;
     VkQueue queue_;
     std::deque<std::unique_ptr<CommandInterface>> commands_;
+    size_t submits_count_ = 0;
 
     unique_ptr_of<VkCommandBuffer> begin_command();
     void end_command(VkCommandBuffer command_buffer);
@@ -21,4 +22,8 @@ class Commander {
     void add_command(std::unique_ptr<CommandInterface> command);
 
     void execute();
+
+    size_t get_submits_count() const {
+        return submits_count_;
+    }
 };
\ No newline at end of file
@@ -0,0 +1,73 @@
+#include "compute_pipeline_builder.hpp"
+
+#include "graphics_error.hpp"
+#include "graphics_manager.hpp"
+
+ComputePipelineBuilder::ComputePipelineBuilder(shared_ptr_of<VkDevice> device, VkPipelineCache pipeline_cache)
+    : device_{device}
+    , pipeline_cache_{pipeline_cache}
+    , pipeline_info_{
+          .sType = VK_STRUCTURE_TYPE_COMPUTE_PIPELINE_CREATE_INFO,
+          .stage =
+              VkPipelineShaderStageCreateInfo{
+                  .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
+                  .stage = VK_SHADER_STAGE_COMPUTE_BIT,
+              },
+          .basePipelineHandle = nullptr,
+          .basePipelineIndex = -1,
+      } {
+}
+
+ComputePipelineBuilder::ComputePipelineBuilder(ComputePipelineBuilder const &other)
+    : device_{other.device_}
+    , pipeline_cache_{other.pipeline_cache_}
+    , entry_point_{other.entry_point_}
+    , specialization_{other.specialization_}
+    , shader_module_{other.shader_module_}
+    , local_size_{other.local_size_}
+    , pipeline_layout_{other.pipeline_layout_}
+    , pipeline_info_{other.pipeline_info_} {
+    update_pointers();
+}
+
+ComputePipelineBuilder &ComputePipelineBuilder::operator=(ComputePipelineBuilder const &other) {
+    device_ = other.device_;
+    pipeline_cache_ = other.pipeline_cache_;
+    entry_point_ = other.entry_point_;
+    specialization_ = other.specialization_;
+    shader_module_ = other.shader_module_;
+    local_size_ = other.local_size_;
+    pipeline_layout_ = other.pipeline_layout_;
+    pipeline_info_ = other.pipeline_info_;
+    update_pointers();
+    return *this;
+}
+
+void ComputePipelineBuilder::update_pointers() {
+    pipeline_info_.stage.pName = entry_point_.c_str();
+    pipeline_info_.stage.pSpecializationInfo = specialization_.get_info();
+}
+
+unique_ptr_of<VkPipeline> ComputePipelineBuilder::make_pipeline() const {
+    if (pipeline_info_.stage.module == nullptr) {
+        raise_error("Compute pipeline has no shader.");
+    }
+    return GraphicsManager::make_compute_pipeline(device_, pipeline_info_, pipeline_cache_);
+}
+
+void ComputePipelineBuilder::set_shader(ShaderContext const &shader) {
+    if (shader.get_stage() != VK_SHADER_STAGE_COMPUTE_BIT) {
+        raise_error("Shader stage {} is not compute.", static_cast<uint32_t>(shader.get_stage()));
+    }
+    entry_point_ = shader.get_entry_point();
+    specialization_ = shader.get_specialization();
+    shader_module_ = shader.get_shader_module();
+    local_size_ = shader.get_reflection().get_local_size();
+    pipeline_info_.stage.module = shader_module_.get();
+    update_pointers();
+}
+
+void ComputePipelineBuilder::set_specialization(SpecializationConstants const &constants) {
+    specialization_ = constants;
+    update_pointers();
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "graphics/graphics_types.hpp"
+#include "graphics/layout_cache.hpp"
+#include "graphics/shader_context.hpp"
+
+#include <array>
+#include <string>
+
+class ComputePipelineBuilder {
+    shared_ptr_of<VkDevice> device_;
+    VkPipelineCache pipeline_cache_;
+    // the stage points to the entry point and the constants kept here
+    std::string entry_point_;
+    SpecializationConstants specialization_;
+    shared_ptr_of<VkShaderModule> shader_module_;
+    std::array<uint32_t, 3> local_size_{1, 1, 1};
+    shared_ptr_of<VkPipelineLayout> pipeline_layout_;
+    VkComputePipelineCreateInfo pipeline_info_;
+
+    void update_pointers();
+
+  public:
+    ComputePipelineBuilder(shared_ptr_of<VkDevice> device, VkPipelineCache pipeline_cache);
+
+    // the copy is a snapshot of the state which can be compiled on another thread
+    ComputePipelineBuilder(ComputePipelineBuilder const &other);
+
+    ComputePipelineBuilder &operator=(ComputePipelineBuilder const &other);
+
+    unique_ptr_of<VkPipeline> make_pipeline() const;
+
+    VkComputePipelineCreateInfo const &get_pipeline_info() const {
+        return pipeline_info_;
+    }
+
+    // workgroup size reflected from the shader
+    std::array<uint32_t, 3> const &get_local_size() const {
+        return local_size_;
+    }
+
+    void set_shader(ShaderContext const &shader);
+
+    // replaces the constants set by the shader, the permutations are compiled as separate pipelines
+    void set_specialization(SpecializationConstants const &constants);
+
+    void set_pipeline_layout(shared_ptr_of<VkPipelineLayout> pipeline_layout) {
+        pipeline_layout_.swap(pipeline_layout);
+        pipeline_info_.layout = pipeline_layout_.get();
+    }
+
+    // the pipeline layout is reflected from the shader and shared through the cache
+    void set_shader_layout(ShaderLayout const &layout, LayoutCache &layout_cache) {
+        set_pipeline_layout(layout_cache.get_pipeline_layout(layout));
+    }
+};
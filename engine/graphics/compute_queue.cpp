@@ -0,0 +1,98 @@
+#include "compute_queue.hpp"
+
+#include "graphics_error.hpp"
+#include "graphics_manager.hpp"
+
+#include "utility/trace.hpp"
+
+#include <limits>
+
+ComputeQueue::ComputeQueue(DeviceContext const &device_context)
+    : device_{device_context.get_device()}
+    , command_pool_{GraphicsManager::make_command_pool(
+          device_, VK_COMMAND_POOL_CREATE_TRANSIENT_BIT, device_context.get_compute_qfm())}
+    , queue_{device_context.get_compute_queue()}
+    , async_{device_context.get_compute_qfm() != device_context.get_graphics_qfm()}
+    , semaphore_{GraphicsManager::make_timeline_semaphore(device_, 0)} {
+    info_println("Use {} compute queue", async_ ? "async" : "graphics");
+}
+
+ComputeQueue::~ComputeQueue() {
+    // the command buffers may still be executed
+    wait(submitted_value_);
+}
+
+void ComputeQueue::add_command(std::unique_ptr<CommandInterface> command) {
+    commands_.push_back(std::move(command));
+}
+
+uint64_t ComputeQueue::submit() {
+    if (commands_.empty()) {
+        return submitted_value_;
+    }
+    trace_zone("ComputeQueue::submit");
+    free_completed();
+    auto command_buffer = GraphicsManager::make_command_buffer(device_, command_pool_);
+    VkCommandBufferBeginInfo begin_info{
+        .sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO,
+        .flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT,
+    };
+    vk_assert(vkBeginCommandBuffer(command_buffer.get(), &begin_info), "Failed to begin command buffer.");
+    for (auto &command : commands_) {
+        command->execute(command_buffer.get());
+    }
+    vk_assert(vkEndCommandBuffer(command_buffer.get()), "Failed to end command buffer.");
+
+    uint64_t value = submitted_value_ + 1;
+    VkTimelineSemaphoreSubmitInfo timeline_info{
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .signalSemaphoreValueCount = 1,
+        .pSignalSemaphoreValues = &value,
+    };
+    VkCommandBuffer command_buffer_handle = command_buffer.get();
+    VkSemaphore semaphore = semaphore_.get();
+    VkSubmitInfo submit_info{
+        .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
+        .pNext = &timeline_info,
+        .commandBufferCount = 1,
+        .pCommandBuffers = &command_buffer_handle,
+        .signalSemaphoreCount = 1,
+        .pSignalSemaphores = &semaphore,
+    };
+    vk_assert(vkQueueSubmit(queue_, 1, &submit_info, nullptr), "Failed to submit the compute queue.");
+    submitted_value_ = value;
+    submissions_.push_back(Submission{.command_buffer = std::move(command_buffer), .commands = std::move(commands_), .value = value});
+    commands_.clear();
+    return value;
+}
+
+void ComputeQueue::wait(uint64_t value) const {
+    if (value == 0 || is_completed(value)) {
+        return;
+    }
+    trace_zone("wait_compute");
+    VkSemaphore semaphore = semaphore_.get();
+    VkSemaphoreWaitInfo wait_info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO,
+        .semaphoreCount = 1,
+        .pSemaphores = &semaphore,
+        .pValues = &value,
+    };
+    vk_assert(vkWaitSemaphores(device_.get(), &wait_info, std::numeric_limits<uint64_t>::max()), "Failed to wait for the compute queue.");
+}
+
+uint64_t ComputeQueue::get_completed_value() const {
+    uint64_t value = 0;
+    vk_assert(vkGetSemaphoreCounterValue(device_.get(), semaphore_.get(), &value), "Failed to get the semaphore value.");
+    return value;
+}
+
+void ComputeQueue::free_completed() {
+    if (submissions_.empty()) {
+        return;
+    }
+    uint64_t completed_value = get_completed_value();
+    while (!submissions_.empty() && submissions_.front().value <= completed_value) {
+        submissions_.pop_front();
+    }
+}
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "command_interface.hpp"
+#include "device_context.hpp"
+
+#include <deque>
+#include <vector>
+
+// submits the compute work without waiting for it, the completion is tracked by the timeline semaphore
+class ComputeQueue {
+    struct Submission {
+        unique_ptr_of<VkCommandBuffer> command_buffer;
+        // the commands are kept with the buffer which may still reference their data
+        std::vector<std::unique_ptr<CommandInterface>> commands;
+        uint64_t value;
+    };
+
+    shared_ptr_of<VkDevice> device_;
+    shared_ptr_of<VkCommandPool> command_pool_;
+    VkQueue queue_;
+    // the queue is asynchronous if its family differs from the graphics one
+    bool async_;
+    unique_ptr_of<VkSemaphore> semaphore_;
+    std::vector<std::unique_ptr<CommandInterface>> commands_;
+    // command buffers and their commands are freed once the semaphore reaches their values
+    std::deque<Submission> submissions_;
+    uint64_t submitted_value_ = 0;
+
+    void free_completed();
+
+  public:
+    // requires the timeline semaphores of Vulkan 1.2
+    explicit ComputeQueue(DeviceContext const &device_context);
+
+    ComputeQueue(ComputeQueue const &) = delete;
+    ComputeQueue &operator=(ComputeQueue const &) = delete;
+
+    ~ComputeQueue();
+
+    void add_command(std::unique_ptr<CommandInterface> command);
+
+    // records the added commands and submits them, returns the value the semaphore is signaled with on their completion,
+    // the resources the commands refer to, e.g. the pipelines, descriptor sets and buffers, must live until then
+    uint64_t submit();
+
+    // blocks until the submitted commands complete, e.g. to read their results on the host
+    void wait(uint64_t value) const;
+
+    bool is_completed(uint64_t value) const {
+        return get_completed_value() >= value;
+    }
+
+    uint64_t get_completed_value() const;
+
+    uint64_t get_submitted_value() const {
+        return submitted_value_;
+    }
+
+    // the graphics frames wait for it to read the results of the compute work
+    VkSemaphore get_semaphore() const {
+        return semaphore_.get();
+    }
+
+    // the resources of the exclusive sharing mode have to be transferred between the families of the async queue
+    bool is_async() const {
+        return async_;
+    }
+};
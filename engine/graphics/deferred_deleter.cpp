@@ -0,0 +1,22 @@
+#include "deferred_deleter.hpp"
+
+void DeferredDeleter::update(uint64_t submitted_frame, uint64_t completed_frame) {
+    std::deque<Entry> released;
+    {
+        std::lock_guard lock{mutex_};
+        submitted_frame_ = submitted_frame;
+        while (!entries_.empty() && entries_.front().frame <= completed_frame) {
+            released.push_back(std::move(entries_.front()));
+            entries_.pop_front();
+        }
+    }
+    // resources are destroyed outside of the lock
+}
+
+void DeferredDeleter::clear() {
+    std::deque<Entry> released;
+    {
+        std::lock_guard lock{mutex_};
+        released.swap(entries_);
+    }
+}
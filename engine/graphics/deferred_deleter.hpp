@@ -0,0 +1,33 @@
+#pragma once
+
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <type_traits>
+
+// keeps resources alive until the frames which may still use them have been completed
+class DeferredDeleter {
+    struct Entry {
+        uint64_t frame;
+        std::shared_ptr<void> resource;
+    };
+
+    std::mutex mutex_;
+    std::deque<Entry> entries_;
+    uint64_t submitted_frame_ = 0;
+
+  public:
+    template <typename T>
+    void retire(T &&resource) {
+        auto holder = std::make_shared<std::decay_t<T>>(std::forward<T>(resource));
+        std::lock_guard lock{mutex_};
+        entries_.push_back(Entry{.frame = submitted_frame_, .resource = std::move(holder)});
+    }
+
+    // releases the resources retired before the completed frame, next retired ones wait for the submitted frame
+    void update(uint64_t submitted_frame, uint64_t completed_frame);
+
+    // releases all the resources, must be called only when the device is idle
+    void clear();
+};
@@ -2,16 +2,6 @@
 
 #include "graphics_error.hpp"
 #include "graphics_manager.hpp"
-#include "image_transition_command.hpp"
-#include "memory_barrier.hpp"
-
-namespace {
-
-    bool has_stencil_component(VkFormat format) {
-        return format == VK_FORMAT_D32_SFLOAT_S8_UINT || format == VK_FORMAT_D24_UNORM_S8_UINT;
-    }
-
-} // namespace
 
 DepthTexture::DepthTexture(shared_ptr_of<VkDevice> device,
                            std::shared_ptr<AllocatorInterface> allocator,
@@ -29,10 +19,12 @@ DepthTexture::~DepthTexture() {
     }
 }
 
-void DepthTexture::update_extent(VkExtent2D const &extent, Commander &transition_commander) {
-    image_view_.release();
+void DepthTexture::update_extent(VkExtent2D const &extent) {
+    image_view_.reset();
+    image_.reset();
     if (block_) {
         allocator_->deallocate(block_);
+        block_ = MemoryBlock();
     }
     VkImageCreateInfo info{
         .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
@@ -64,23 +56,5 @@ void DepthTexture::update_extent(VkExtent2D const &extent, Commander &transition
               reinterpret_cast<uintptr_t>(memory),
               offset);
     image_view_ = GraphicsManager::make_image_view(device_, image_.get(), format_, VK_IMAGE_ASPECT_DEPTH_BIT);
-    VkImageAspectFlags image_aspect = VK_IMAGE_ASPECT_DEPTH_BIT;
-    if (has_stencil_component(format_)) {
-        image_aspect |= VK_IMAGE_ASPECT_STENCIL_BIT;
-    }
-    transition_commander.add_command(std::make_unique<ImageTransitionCommand>(
-        VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
-        VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
-        MemoryBarrier::make_image_barrier(
-            image_.get(),
-            image_aspect,
-            MemoryBarrier::ImageInfo{
-                .access_mask = 0,
-                .layout = VK_IMAGE_LAYOUT_UNDEFINED,
-            },
-            MemoryBarrier::ImageInfo{
-                .access_mask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
-                .layout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL,
-            })));
-    transition_commander.execute();
+    // the layout transition is performed by the render pass since its initial layout is undefined
 }
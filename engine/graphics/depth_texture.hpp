@@ -1,7 +1,6 @@
 #pragma once
 
 #include "allocator_interface.hpp"
-#include "commander.hpp"
 
 class DepthTexture {
     shared_ptr_of<VkDevice> device_;
@@ -25,5 +24,5 @@ class DepthTexture {
         return image_view_.get();
     }
 
-    void update_extent(VkExtent2D const &extent, Commander &transition_commander);
+    void update_extent(VkExtent2D const &extent);
 };
\ No newline at end of file
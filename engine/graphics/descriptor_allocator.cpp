@@ -0,0 +1,96 @@
+#include "descriptor_allocator.hpp"
+
+#include "graphics_error.hpp"
+#include "graphics_manager.hpp"
+
+#include "utility/trace.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+std::vector<DescriptorAllocator::PoolRatio> DescriptorAllocator::get_default_ratios() {
+    return {
+        PoolRatio{.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, .ratio = 2.0f},
+        PoolRatio{.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER, .ratio = 2.0f},
+        PoolRatio{.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, .ratio = 1.0f},
+        PoolRatio{.type = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, .ratio = 1.0f},
+        PoolRatio{.type = VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE, .ratio = 0.5f},
+        PoolRatio{.type = VK_DESCRIPTOR_TYPE_SAMPLER, .ratio = 0.5f},
+        PoolRatio{.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, .ratio = 0.5f},
+        PoolRatio{.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC, .ratio = 0.5f},
+    };
+}
+
+DescriptorAllocator::DescriptorAllocator(shared_ptr_of<VkDevice> device,
+                                         uint32_t sets_per_pool,
+                                         std::vector<PoolRatio> const &ratios,
+                                         VkDescriptorPoolCreateFlags pool_flags)
+    : device_{std::move(device)}
+    , sets_per_pool_{std::max(sets_per_pool, 1u)}
+    , pool_flags_{pool_flags} {
+    pool_sizes_.reserve(ratios.size());
+    for (auto const &ratio : ratios) {
+        pool_sizes_.push_back(VkDescriptorPoolSize{
+            .type = ratio.type,
+            .descriptorCount = std::max(1u, static_cast<uint32_t>(std::ceil(ratio.ratio * sets_per_pool_))),
+        });
+    }
+}
+
+VkDescriptorPool DescriptorAllocator::add_pool() {
+    if (free_pools_.empty()) {
+        used_pools_.push_back(GraphicsManager::make_descriptor_pool(device_, sets_per_pool_, pool_sizes_, pool_flags_));
+    } else {
+        used_pools_.push_back(std::move(free_pools_.back()));
+        free_pools_.pop_back();
+    }
+    return used_pools_.back().get();
+}
+
+VkResult DescriptorAllocator::try_allocate(VkDescriptorPool pool,
+                                           std::span<VkDescriptorSetLayout const> layouts,
+                                           VkDescriptorSet *descriptor_sets) {
+    VkDescriptorSetAllocateInfo info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO,
+        .descriptorPool = pool,
+        .descriptorSetCount = static_cast<uint32_t>(layouts.size()),
+        .pSetLayouts = layouts.data(),
+    };
+    return vkAllocateDescriptorSets(device_.get(), &info, descriptor_sets);
+}
+
+VkDescriptorSet DescriptorAllocator::allocate(VkDescriptorSetLayout layout) {
+    return allocate(std::span(&layout, 1)).front();
+}
+
+std::vector<VkDescriptorSet> DescriptorAllocator::allocate(std::span<VkDescriptorSetLayout const> layouts) {
+    std::vector<VkDescriptorSet> descriptor_sets(layouts.size());
+    std::lock_guard lock{mutex_};
+    VkDescriptorPool pool = used_pools_.empty() ? add_pool() : used_pools_.back().get();
+    VkResult result = try_allocate(pool, layouts, descriptor_sets.data());
+    if (result == VK_ERROR_OUT_OF_POOL_MEMORY || result == VK_ERROR_FRAGMENTED_POOL) {
+        trace_zone("add_descriptor_pool");
+        ++statistics_.pool_misses;
+        // the exhausted pool stays in the chain until the reset
+        result = try_allocate(add_pool(), layouts, descriptor_sets.data());
+    }
+    vk_assert(result, "Failed to allocate {} descriptor sets.", layouts.size());
+    statistics_.allocated_sets += layouts.size();
+    return descriptor_sets;
+}
+
+void DescriptorAllocator::reset() {
+    std::lock_guard lock{mutex_};
+    for (auto &pool : used_pools_) {
+        vk_assert(vkResetDescriptorPool(device_.get(), pool.get(), 0), "Failed to reset descriptor pool.");
+        free_pools_.push_back(std::move(pool));
+    }
+    used_pools_.clear();
+}
+
+DescriptorAllocator::Statistics DescriptorAllocator::get_statistics() const {
+    std::lock_guard lock{mutex_};
+    Statistics statistics = statistics_;
+    statistics.pools_count = used_pools_.size() + free_pools_.size();
+    return statistics;
+}
@@ -0,0 +1,62 @@
+#pragma once
+
+#include "graphics_types.hpp"
+
+#include <mutex>
+#include <span>
+#include <vector>
+
+// allocates the descriptor sets from the chain of the fixed size pools, a new pool is added when the last one is exhausted
+class DescriptorAllocator {
+  public:
+    // descriptors of the type reserved per set of the pool
+    struct PoolRatio {
+        VkDescriptorType type;
+        float ratio;
+    };
+
+    struct Statistics {
+        size_t pools_count = 0;
+        uint64_t allocated_sets = 0;
+        // allocations which have not fit into the current pool
+        uint64_t pool_misses = 0;
+    };
+
+  private:
+    shared_ptr_of<VkDevice> device_;
+    uint32_t sets_per_pool_;
+    std::vector<VkDescriptorPoolSize> pool_sizes_;
+    VkDescriptorPoolCreateFlags pool_flags_;
+    mutable std::mutex mutex_;
+    // the sets are allocated from the last pool, the previous ones are exhausted
+    std::vector<unique_ptr_of<VkDescriptorPool>> used_pools_;
+    // pools which have been reset and wait to be used again
+    std::vector<unique_ptr_of<VkDescriptorPool>> free_pools_;
+    Statistics statistics_;
+
+    // the reset pools are used before the new ones are created
+    VkDescriptorPool add_pool();
+
+    VkResult try_allocate(VkDescriptorPool pool, std::span<VkDescriptorSetLayout const> layouts, VkDescriptorSet *descriptor_sets);
+
+  public:
+    static std::vector<PoolRatio> get_default_ratios();
+
+    DescriptorAllocator(shared_ptr_of<VkDevice> device,
+                        uint32_t sets_per_pool = 256,
+                        std::vector<PoolRatio> const &ratios = get_default_ratios(),
+                        VkDescriptorPoolCreateFlags pool_flags = 0);
+
+    DescriptorAllocator(DescriptorAllocator const &) = delete;
+    DescriptorAllocator &operator=(DescriptorAllocator const &) = delete;
+
+    // a set larger than the whole pool is not allocated, may be called from any thread
+    VkDescriptorSet allocate(VkDescriptorSetLayout layout);
+
+    std::vector<VkDescriptorSet> allocate(std::span<VkDescriptorSetLayout const> layouts);
+
+    // frees all the allocated sets at once, they must not be used by the device anymore
+    void reset();
+
+    Statistics get_statistics() const;
+};
@@ -1,13 +1,37 @@
 #include "descriptor_set.hpp"
 
+#include "graphics_error.hpp"
 #include "graphics_manager.hpp"
+#include "swapchain_presenter.hpp"
 
 #include <algorithm>
 
 using namespace std::placeholders;
 
-DescriptorSet::DescriptorSet(shared_ptr_of<VkDevice> device, std::vector<std::shared_ptr<DescriptorInterface>> const &descriptors)
-    : device_{device} {
+namespace {
+
+    bool is_image_type(VkDescriptorType type) {
+        return type == VK_DESCRIPTOR_TYPE_SAMPLER || type == VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER ||
+               type == VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE || type == VK_DESCRIPTOR_TYPE_STORAGE_IMAGE ||
+               type == VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+    }
+
+    bool is_texel_buffer_type(VkDescriptorType type) {
+        return type == VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER || type == VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+    }
+
+    bool is_buffer_type(VkDescriptorType type) {
+        return type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER ||
+               type == VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC || type == VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC;
+    }
+
+} // namespace
+
+DescriptorSet::DescriptorSet(shared_ptr_of<VkDevice> device,
+                             std::vector<std::shared_ptr<DescriptorInterface>> const &descriptors,
+                             std::shared_ptr<DescriptorAllocator> allocator)
+    : device_{device}
+    , allocator_{std::move(allocator)} {
     std::vector<VkDescriptorSetLayoutBinding> bindings(descriptors.size());
     std::transform(descriptors.begin(), descriptors.end(), bindings.begin(), std::bind(&DescriptorInterface::get_binding, _1));
     set_layout_ = GraphicsManager::make_descriptor_set_layout(device_, bindings);
@@ -15,24 +39,162 @@ DescriptorSet::DescriptorSet(shared_ptr_of<VkDevice> device, std::vector<std::sh
     for (size_t i = 0; i < descriptors.size(); ++i) {
         descriptors_[i].descriptor = descriptors[i];
         descriptors_[i].type = bindings[i].descriptorType;
+        descriptors_[i].binding = bindings[i].binding;
+        descriptors_[i].count = std::max(bindings[i].descriptorCount, 1u);
     }
+    make_allocator();
+    make_update_template();
 }
 
-void DescriptorSet::set_swapchain_images_count(uint32_t images_count) {
-    if (images_count > descriptor_sets_.size()) {
-        std::vector<VkDescriptorPoolSize> pool_sizes(descriptors_.size());
-        std::transform(descriptors_.begin(), descriptors_.end(), pool_sizes.begin(), [images_count](auto info) {
-            return VkDescriptorPoolSize{.type = info.type, .descriptorCount = images_count};
+DescriptorSet::DescriptorSet(shared_ptr_of<VkDevice> device,
+                             ShaderLayout const &layout,
+                             uint32_t set,
+                             LayoutCache &layout_cache,
+                             std::vector<std::shared_ptr<DescriptorInterface>> const &descriptors,
+                             std::shared_ptr<DescriptorAllocator> allocator)
+    : device_{device}
+    , allocator_{std::move(allocator)} {
+    if (set >= layout.get_sets_count()) {
+        raise_error("There is no descriptor set {} in the shaders.", set);
+    }
+    auto const &bindings = layout.get_set_bindings(set);
+    set_layout_ = layout_cache.get_set_layout(bindings);
+    descriptors_.resize(descriptors.size());
+    for (size_t i = 0; i < descriptors.size(); ++i) {
+        VkDescriptorSetLayoutBinding binding = descriptors[i]->get_binding();
+        auto iter = std::find_if(bindings.begin(), bindings.end(), [&binding](auto const &reflected) {
+            return reflected.binding == binding.binding;
         });
-        descriptor_pool_ = GraphicsManager::make_descriptor_pool(device_, images_count, pool_sizes);
-        std::vector<VkDescriptorSetLayout> set_layouts(images_count, set_layout_.get());
-        descriptor_sets_ = GraphicsManager::allocate_descriptor_sets(device_, descriptor_pool_.get(), set_layouts);
-        std::vector<VkWriteDescriptorSet> write_sets(descriptors_.size() * descriptor_sets_.size());
-        for (size_t i = 0, n = 0; i < descriptor_sets_.size(); ++i) {
-            for (size_t j = 0; j < descriptors_.size(); ++j, ++n) {
-                write_sets[n] = descriptors_[j].descriptor->get_write(descriptor_sets_[i], i);
+        if (iter == bindings.end() || iter->descriptorType != binding.descriptorType) {
+            raise_error("Descriptor of binding {} does not match the set {} of the shaders.", binding.binding, set);
+        }
+        descriptors_[i].descriptor = descriptors[i];
+        descriptors_[i].type = iter->descriptorType;
+        descriptors_[i].binding = binding.binding;
+        descriptors_[i].count = std::max(binding.descriptorCount, 1u);
+    }
+    make_allocator();
+    make_update_template();
+}
+
+void DescriptorSet::make_allocator() {
+    if (allocator_) {
+        return;
+    }
+    std::vector<DescriptorAllocator::PoolRatio> ratios(descriptors_.size());
+    std::transform(descriptors_.begin(), descriptors_.end(), ratios.begin(), [](auto const &info) {
+        return DescriptorAllocator::PoolRatio{
+            .type = info.type,
+            .ratio = static_cast<float>(std::max(info.descriptor->get_binding().descriptorCount, 1u)),
+        };
+    });
+    allocator_ = std::make_shared<DescriptorAllocator>(device_, SwapchainPresenter::max_frames_count, ratios);
+}
+
+void DescriptorSet::make_update_template() {
+    std::vector<VkDescriptorUpdateTemplateEntry> entries(descriptors_.size());
+    size_t elements_count = 0;
+    for (size_t i = 0; i < descriptors_.size(); ++i) {
+        auto &info = descriptors_[i];
+        if (!is_image_type(info.type) && !is_texel_buffer_type(info.type) && !is_buffer_type(info.type)) {
+            raise_error("Descriptor of binding {} has the type {} which is not supported.", info.binding, static_cast<int>(info.type));
+        }
+        info.offset = elements_count;
+        entries[i] = VkDescriptorUpdateTemplateEntry{
+            .dstBinding = info.binding,
+            .dstArrayElement = 0,
+            .descriptorCount = info.count,
+            .descriptorType = info.type,
+            .offset = info.offset * sizeof(DescriptorData),
+            .stride = sizeof(DescriptorData),
+        };
+        elements_count += info.count;
+    }
+    update_template_ = GraphicsManager::make_descriptor_update_template(device_, set_layout_.get(), entries);
+    data_.resize(elements_count);
+}
+
+size_t DescriptorSet::find_descriptor(uint32_t binding) const {
+    auto iter = std::find_if(descriptors_.begin(), descriptors_.end(), [binding](auto const &info) {
+        return info.binding == binding;
+    });
+    if (iter == descriptors_.end()) {
+        raise_error("There is no descriptor of binding {} in the set.", binding);
+    }
+    return static_cast<size_t>(iter - descriptors_.begin());
+}
+
+void DescriptorSet::write_set(size_t image_index) {
+    VkDescriptorSet descriptor_set = descriptor_sets_[image_index];
+    for (auto const &info : descriptors_) {
+        VkWriteDescriptorSet write = info.descriptor->get_write(descriptor_set, image_index);
+        if (write.dstArrayElement != 0 || write.descriptorCount != info.count) {
+            raise_error("Descriptor of binding {} does not write all the elements of the binding.", info.binding);
+        }
+        DescriptorData *data = &data_[info.offset];
+        for (uint32_t i = 0; i < info.count; ++i) {
+            if (is_image_type(info.type)) {
+                data[i].image = write.pImageInfo[i];
+            } else if (is_texel_buffer_type(info.type)) {
+                data[i].texel_buffer = write.pTexelBufferView[i];
+            } else {
+                data[i].buffer = write.pBufferInfo[i];
             }
         }
-        vkUpdateDescriptorSets(device_.get(), static_cast<uint32_t>(write_sets.size()), write_sets.data(), 0, nullptr);
     }
+    vkUpdateDescriptorSetWithTemplate(device_.get(), descriptor_set, update_template_.get(), data_.data());
+    std::fill_n(dirty_.begin() + image_index * descriptors_.size(), descriptors_.size(), false);
+}
+
+void DescriptorSet::set_swapchain_images_count(uint32_t images_count) {
+    if (images_count <= descriptor_sets_.size()) {
+        return;
+    }
+    size_t first_index = descriptor_sets_.size();
+    std::vector<VkDescriptorSetLayout> set_layouts(images_count - first_index, set_layout_.get());
+    auto descriptor_sets = allocator_->allocate(set_layouts);
+    descriptor_sets_.insert(descriptor_sets_.end(), descriptor_sets.begin(), descriptor_sets.end());
+    dirty_.resize(descriptor_sets_.size() * descriptors_.size(), false);
+    for (size_t i = first_index; i < descriptor_sets_.size(); ++i) {
+        write_set(i);
+    }
+}
+
+void DescriptorSet::set_descriptor(std::shared_ptr<DescriptorInterface> descriptor) {
+    VkDescriptorSetLayoutBinding binding = descriptor->get_binding();
+    auto &info = descriptors_[find_descriptor(binding.binding)];
+    if (binding.descriptorType != info.type || std::max(binding.descriptorCount, 1u) != info.count) {
+        raise_error("Descriptor of binding {} does not match the replaced one.", binding.binding);
+    }
+    info.descriptor = std::move(descriptor);
+    mark_dirty(binding.binding);
+}
+
+void DescriptorSet::mark_dirty(uint32_t binding) {
+    size_t index = find_descriptor(binding);
+    for (size_t i = 0; i < descriptor_sets_.size(); ++i) {
+        dirty_[i * descriptors_.size() + index] = true;
+    }
+}
+
+bool DescriptorSet::update(size_t image_index) {
+    auto dirty = dirty_.begin() + image_index * descriptors_.size();
+    auto dirty_count = static_cast<size_t>(std::count(dirty, dirty + descriptors_.size(), true));
+    if (dirty_count == 0) {
+        return false;
+    }
+    if (dirty_count == descriptors_.size()) {
+        write_set(image_index);
+        return true;
+    }
+    // only the changed descriptors are written, the template would write the whole set
+    writes_.clear();
+    for (size_t i = 0; i < descriptors_.size(); ++i) {
+        if (dirty[i]) {
+            writes_.push_back(descriptors_[i].descriptor->get_write(descriptor_sets_[image_index], image_index));
+            dirty[i] = false;
+        }
+    }
+    vkUpdateDescriptorSets(device_.get(), static_cast<uint32_t>(writes_.size()), writes_.data(), 0, nullptr);
+    return true;
 }
@@ -1,6 +1,8 @@
 #pragma once
 
+#include "descriptor_allocator.hpp"
 #include "descriptor_interface.hpp"
+#include "layout_cache.hpp"
 
 #include <vector>
 
@@ -8,20 +10,68 @@ class DescriptorSet {
     struct DescriptorInfo {
         std::shared_ptr<DescriptorInterface> descriptor;
         VkDescriptorType type;
+        uint32_t binding;
+        uint32_t count;
+        // index of the first element of the descriptor in the packed data
+        size_t offset;
+    };
+
+    // element of the packed data read by the update template, every descriptor takes the elements of its count
+    union DescriptorData {
+        VkDescriptorImageInfo image;
+        VkDescriptorBufferInfo buffer;
+        VkBufferView texel_buffer;
     };
 
     shared_ptr_of<VkDevice> device_;
-    unique_ptr_of<VkDescriptorSetLayout> set_layout_;
-    unique_ptr_of<VkDescriptorPool> descriptor_pool_;
+    shared_ptr_of<VkDescriptorSetLayout> set_layout_;
+    // the sets are returned to the pools when the allocator is reset or destroyed
+    std::shared_ptr<DescriptorAllocator> allocator_;
     std::vector<VkDescriptorSet> descriptor_sets_;
     std::vector<DescriptorInfo> descriptors_;
-    
+    // the whole set is written by a single call from the packed data
+    unique_ptr_of<VkDescriptorUpdateTemplate> update_template_;
+    std::vector<DescriptorData> data_;
+    // flag of every descriptor of every image whose set has to be written again
+    std::vector<bool> dirty_;
+    std::vector<VkWriteDescriptorSet> writes_;
+
+    // the own allocator is sized for the sets of this layout only
+    void make_allocator();
+
+    void make_update_template();
+
+    size_t find_descriptor(uint32_t binding) const;
+
+    void write_set(size_t image_index);
 
   public:
-    DescriptorSet(shared_ptr_of<VkDevice> device, std::vector<std::shared_ptr<DescriptorInterface>> const &descriptors);
+    // the sets are allocated from the shared allocator, or from the own one if it's null
+    DescriptorSet(shared_ptr_of<VkDevice> device,
+                  std::vector<std::shared_ptr<DescriptorInterface>> const &descriptors,
+                  std::shared_ptr<DescriptorAllocator> allocator = nullptr);
+
+    // the layout of the set is reflected from the shaders, every descriptor has to match the binding of the set
+    DescriptorSet(shared_ptr_of<VkDevice> device,
+                  ShaderLayout const &layout,
+                  uint32_t set,
+                  LayoutCache &layout_cache,
+                  std::vector<std::shared_ptr<DescriptorInterface>> const &descriptors,
+                  std::shared_ptr<DescriptorAllocator> allocator = nullptr);
 
+    // only the sets of the new images are allocated and written
     void set_swapchain_images_count(uint32_t images_count);
 
+    // replaces the descriptor of the same binding and type, the sets are written again by the update
+    void set_descriptor(std::shared_ptr<DescriptorInterface> descriptor);
+
+    // the descriptor of the binding has changed, e.g. its buffer was recreated, the sets are written again by the update
+    void mark_dirty(uint32_t binding);
+
+    // writes the changed descriptors of the image set which must not be used by the pending frames, returns true if
+    // the set was written so the command buffers binding it have to be recorded again
+    bool update(size_t image_index);
+
     VkDescriptorSet get_descriptor_set(size_t image_index) const {
         return descriptor_sets_[image_index];
     }
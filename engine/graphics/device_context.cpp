@@ -43,7 +43,11 @@ namespace {
             graphics_qfms = select_qfm_indices(qfm_properties, VK_QUEUE_GRAPHICS_BIT);
             transfer_qfms = select_qfm_indices(qfm_properties, VK_QUEUE_TRANSFER_BIT);
             compute_qfms = select_qfm_indices(qfm_properties, VK_QUEUE_COMPUTE_BIT);
-            std::erase_if(graphics_qfms, [device, surface](QueueFamily const &qfm) { return !is_surface_supported(device, surface, qfm); });
+            // offscreen rendering does not need a queue family supporting presentation
+            if (surface != nullptr) {
+                std::erase_if(graphics_qfms,
+                              [device, surface](QueueFamily const &qfm) { return !is_surface_supported(device, surface, qfm); });
+            }
         }
 
         std::string get_name() const {
@@ -148,6 +152,18 @@ namespace {
         }
     };
 
+    std::unordered_set<std::string> get_supported_extensions(VkPhysicalDevice device) {
+        uint32_t extensions_count;
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensions_count, nullptr);
+        std::vector<VkExtensionProperties> extensions(extensions_count);
+        vkEnumerateDeviceExtensionProperties(device, nullptr, &extensions_count, extensions.data());
+        std::unordered_set<std::string> names;
+        for (auto const &extension : extensions) {
+            names.insert(extension.extensionName);
+        }
+        return names;
+    }
+
     VkQueue get_device_queue(VkDevice device, uint32_t qfm_index, uint32_t queue_index) {
         VkQueue queue;
         vkGetDeviceQueue(device, qfm_index, queue_index, &queue);
@@ -156,7 +172,10 @@ namespace {
 
 } // namespace
 
-DeviceContext::DeviceContext(VkInstance instance, VkSurfaceKHR surface) {
+DeviceContext::DeviceContext(VkInstance instance,
+                             VkSurfaceKHR surface,
+                             std::filesystem::path const &pipeline_cache_path,
+                             bool surface_maintenance) {
     PhysicalDevice device = PhysicalDevice::get_best_physical_device(instance, surface);
     phys_device_ = device.device;
     properties_ = device.properties;
@@ -249,8 +268,78 @@ DeviceContext::DeviceContext(VkInstance instance, VkSurfaceKHR surface) {
             .pQueuePriorities = queue_priorities.data(),
         });
     }
-    std::vector<char const *> extension_names{VK_KHR_SWAPCHAIN_EXTENSION_NAME};
-    device_ = GraphicsManager::make_device(phys_device_, queue_infos, extension_names);
+    std::vector<char const *> extension_names;
+    if (surface != nullptr) {
+        extension_names.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME);
+    }
+    // optional extensions are enabled when supported, their features structures are chained to be queried and enabled
+    auto supported_extensions = get_supported_extensions(phys_device_);
+    // the supported features are queried into the separate chain so only the ones used by the engine are enabled
+    DeviceFeatures supported;
+    void **supported_next = &supported.features.pNext;
+    void **enabled_next = &device_features_.features.pNext;
+    auto chain_features = [&](auto member) {
+        *supported_next = &(supported.*member);
+        supported_next = &(supported.*member).pNext;
+        *enabled_next = &(device_features_.*member);
+        enabled_next = &(device_features_.*member).pNext;
+    };
+    // features of the core version are chained the same way
+    if (properties_.apiVersion >= VK_API_VERSION_1_2) {
+        chain_features(&DeviceFeatures::vulkan12);
+    }
+    auto enable_extensions = [&](std::initializer_list<char const *> names, auto... members) {
+        for (auto name : names) {
+            if (!supported_extensions.contains(name)) {
+                return;
+            }
+        }
+        for (auto name : names) {
+            extension_names.push_back(name);
+            info_println("Enable optional extension {}", name);
+        }
+        (chain_features(members), ...);
+    };
+    if (surface != nullptr) {
+        enable_extensions({VK_KHR_PRESENT_ID_EXTENSION_NAME, VK_KHR_PRESENT_WAIT_EXTENSION_NAME},
+                          &DeviceFeatures::present_id,
+                          &DeviceFeatures::present_wait);
+    }
+    if (surface != nullptr && surface_maintenance) {
+        enable_extensions({VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME}, &DeviceFeatures::swapchain_maintenance);
+    }
+    enable_extensions({VK_EXT_PIPELINE_CREATION_CACHE_CONTROL_EXTENSION_NAME, VK_EXT_SHADER_MODULE_IDENTIFIER_EXTENSION_NAME},
+                      &DeviceFeatures::pipeline_cache_control,
+                      &DeviceFeatures::shader_module_identifier);
+    enable_extensions({VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME, VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME},
+                      &DeviceFeatures::graphics_pipeline_library);
+    vkGetPhysicalDeviceFeatures2(phys_device_, &supported.features);
+    // the rest of the features, e.g. robust buffer access, cost performance and stay disabled
+    auto &enabled = device_features_;
+    // the features required by the device selection are enabled so the shaders may rely on them
+    enabled.features.features.geometryShader = supported.features.features.geometryShader;
+    enabled.features.features.samplerAnisotropy = supported.features.features.samplerAnisotropy;
+    enabled.features.features.pipelineStatisticsQuery = supported.features.features.pipelineStatisticsQuery;
+    enabled.features.features.occlusionQueryPrecise = supported.features.features.occlusionQueryPrecise;
+    enabled.vulkan12.timelineSemaphore = supported.vulkan12.timelineSemaphore;
+    // descriptor indexing of the bindless table
+    enabled.vulkan12.runtimeDescriptorArray = supported.vulkan12.runtimeDescriptorArray;
+    enabled.vulkan12.descriptorBindingPartiallyBound = supported.vulkan12.descriptorBindingPartiallyBound;
+    enabled.vulkan12.descriptorBindingSampledImageUpdateAfterBind = supported.vulkan12.descriptorBindingSampledImageUpdateAfterBind;
+    enabled.vulkan12.descriptorBindingStorageBufferUpdateAfterBind = supported.vulkan12.descriptorBindingStorageBufferUpdateAfterBind;
+    // present wait requires the identifiers of the presents
+    if (supported.present_id.presentId == VK_TRUE && supported.present_wait.presentWait == VK_TRUE) {
+        enabled.present_id.presentId = VK_TRUE;
+        enabled.present_wait.presentWait = VK_TRUE;
+    }
+    enabled.pipeline_cache_control.pipelineCreationCacheControl = supported.pipeline_cache_control.pipelineCreationCacheControl;
+    enabled.shader_module_identifier.shaderModuleIdentifier = supported.shader_module_identifier.shaderModuleIdentifier;
+    enabled.graphics_pipeline_library.graphicsPipelineLibrary = supported.graphics_pipeline_library.graphicsPipelineLibrary;
+    // the present fences retire the old swapchains without waiting for the present queue
+    enabled.swapchain_maintenance.swapchainMaintenance1 = supported.swapchain_maintenance.swapchainMaintenance1;
+    extensions_.insert(extension_names.begin(), extension_names.end());
+    device_ = GraphicsManager::make_device(phys_device_, queue_infos, extension_names, device_features_.features);
+    pipeline_cache_ = std::make_unique<PipelineCache>(device_, properties_, pipeline_cache_path);
 }
 
 VkQueue DeviceContext::get_graphics_queue() const {
@@ -1,24 +1,58 @@
 #pragma once
 
 #include "graphics_types.hpp"
+#include "pipeline_cache.hpp"
+
+#include <filesystem>
+#include <memory>
+#include <string>
+#include <unordered_set>
 
 struct QueueFamily {
     VkQueueFamilyProperties properties;
     uint32_t index;
 };
 
+// chain of the device features which are queried and enabled together with the optional extensions, the device context
+// keeps the enabled ones
+struct DeviceFeatures {
+    VkPhysicalDeviceFeatures2 features{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2};
+    VkPhysicalDeviceVulkan12Features vulkan12{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VULKAN_1_2_FEATURES};
+    VkPhysicalDevicePresentIdFeaturesKHR present_id{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR};
+    VkPhysicalDevicePresentWaitFeaturesKHR present_wait{.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR};
+    VkPhysicalDevicePipelineCreationCacheControlFeaturesEXT pipeline_cache_control{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_CREATION_CACHE_CONTROL_FEATURES_EXT};
+    VkPhysicalDeviceShaderModuleIdentifierFeaturesEXT shader_module_identifier{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SHADER_MODULE_IDENTIFIER_FEATURES_EXT};
+    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT graphics_pipeline_library{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT};
+    VkPhysicalDeviceSwapchainMaintenance1FeaturesEXT swapchain_maintenance{
+        .sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SWAPCHAIN_MAINTENANCE_1_FEATURES_EXT};
+
+    DeviceFeatures() = default;
+    DeviceFeatures(DeviceFeatures const &) = delete;
+    DeviceFeatures &operator=(DeviceFeatures const &) = delete;
+};
+
 class DeviceContext {
     VkPhysicalDevice phys_device_;
     VkPhysicalDeviceProperties properties_;
     VkPhysicalDeviceFeatures features_;
+    DeviceFeatures device_features_;
+    std::unordered_set<std::string> extensions_;
     QueueFamily graphics_qfm_;
     QueueFamily present_qfm_;
     QueueFamily compute_qfm_;
     QueueFamily transfer_qfm_;
     shared_ptr_of<VkDevice> device_;
+    std::unique_ptr<PipelineCache> pipeline_cache_;
 
   public:
-    DeviceContext(VkInstance instance, VkSurfaceKHR surface);
+    // the swapchain maintenance is enabled only if the instance has enabled the surface maintenance
+    DeviceContext(VkInstance instance,
+                  VkSurfaceKHR surface,
+                  std::filesystem::path const &pipeline_cache_path = {},
+                  bool surface_maintenance = false);
 
     VkPhysicalDevice get_physical_device() const {
         return phys_device_;
@@ -28,10 +62,58 @@ class DeviceContext {
         return device_;
     }
 
+    VkPhysicalDeviceProperties const &get_properties() const {
+        return properties_;
+    }
+
+    // only the features used by the engine are enabled when supported
+    DeviceFeatures const &get_features() const {
+        return device_features_;
+    }
+
+    // passed to every pipeline creation
+    VkPipelineCache get_pipeline_cache() const {
+        return pipeline_cache_->get_pipeline_cache();
+    }
+
+    void save_pipeline_cache() {
+        pipeline_cache_->save();
+    }
+
+    bool is_extension_enabled(std::string const &name) const {
+        return extensions_.contains(name);
+    }
+
+    bool is_pipeline_library_supported() const {
+        return is_extension_enabled(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME) &&
+               device_features_.graphics_pipeline_library.graphicsPipelineLibrary == VK_TRUE;
+    }
+
+    // the presents are chained with their identifiers which are waited for
+    // occlusion queries may count the passed samples instead of reporting only whether any sample has passed
+    bool is_precise_occlusion_supported() const {
+        return device_features_.features.features.occlusionQueryPrecise == VK_TRUE;
+    }
+
+    // the presents signal the fences when the presentation engine has done with their semaphores
+    bool is_present_fence_supported() const {
+        return is_extension_enabled(VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME) &&
+               device_features_.swapchain_maintenance.swapchainMaintenance1 == VK_TRUE;
+    }
+
+    bool is_present_wait_supported() const {
+        return is_extension_enabled(VK_KHR_PRESENT_WAIT_EXTENSION_NAME) && device_features_.present_id.presentId == VK_TRUE &&
+               device_features_.present_wait.presentWait == VK_TRUE;
+    }
+
     uint32_t get_graphics_qfm() const {
         return graphics_qfm_.index;
     }
 
+    VkQueueFamilyProperties const &get_graphics_qfm_properties() const {
+        return graphics_qfm_.properties;
+    }
+
     uint32_t get_present_qfm() const {
         return present_qfm_.index;
     }
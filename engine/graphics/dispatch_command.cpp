@@ -0,0 +1,43 @@
+#include "dispatch_command.hpp"
+
+DispatchCommand::DispatchCommand(
+    VkPipeline pipeline, VkPipelineLayout pipeline_layout, uint32_t groups_x, uint32_t groups_y, uint32_t groups_z)
+    : pipeline_{pipeline}
+    , pipeline_layout_{pipeline_layout}
+    , groups_count_{groups_x, groups_y, groups_z} {
+}
+
+DispatchCommand::DispatchCommand(VkPipeline pipeline, VkPipelineLayout pipeline_layout, VkBuffer indirect_buffer, VkDeviceSize indirect_offset)
+    : pipeline_{pipeline}
+    , pipeline_layout_{pipeline_layout}
+    , groups_count_{}
+    , indirect_buffer_{indirect_buffer}
+    , indirect_offset_{indirect_offset} {
+}
+
+void DispatchCommand::execute(VkCommandBuffer command_buffer) {
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline_);
+    if (!descriptor_sets_.empty()) {
+        vkCmdBindDescriptorSets(command_buffer,
+                                VK_PIPELINE_BIND_POINT_COMPUTE,
+                                pipeline_layout_,
+                                0,
+                                static_cast<uint32_t>(descriptor_sets_.size()),
+                                descriptor_sets_.data(),
+                                0,
+                                nullptr);
+    }
+    if (!push_constants_.empty()) {
+        vkCmdPushConstants(command_buffer,
+                           pipeline_layout_,
+                           VK_SHADER_STAGE_COMPUTE_BIT,
+                           0,
+                           static_cast<uint32_t>(push_constants_.size()),
+                           push_constants_.data());
+    }
+    if (indirect_buffer_ != nullptr) {
+        vkCmdDispatchIndirect(command_buffer, indirect_buffer_, indirect_offset_);
+    } else {
+        vkCmdDispatch(command_buffer, groups_count_[0], groups_count_[1], groups_count_[2]);
+    }
+}
@@ -0,0 +1,46 @@
+#pragma once
+
+#include "command_interface.hpp"
+
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <vector>
+
+// the handles are not owned so the pipeline, its layout, the descriptor sets and the indirect buffer must live until
+// the submission of the command completes, e.g. until ComputeQueue::is_completed returns true for its value
+class DispatchCommand : public CommandInterface {
+    VkPipeline pipeline_;
+    VkPipelineLayout pipeline_layout_;
+    std::array<uint32_t, 3> groups_count_;
+    std::vector<VkDescriptorSet> descriptor_sets_;
+    std::vector<std::byte> push_constants_;
+    // the dispatch reads its group counts from the buffer when it's set
+    VkBuffer indirect_buffer_ = nullptr;
+    VkDeviceSize indirect_offset_ = 0;
+
+  public:
+    DispatchCommand(VkPipeline pipeline, VkPipelineLayout pipeline_layout, uint32_t groups_x, uint32_t groups_y = 1, uint32_t groups_z = 1);
+
+    // the group counts are written by the device, e.g. by a culling pass, as VkDispatchIndirectCommand
+    DispatchCommand(VkPipeline pipeline, VkPipelineLayout pipeline_layout, VkBuffer indirect_buffer, VkDeviceSize indirect_offset);
+
+    // bound starting from the set 0
+    void set_descriptor_sets(std::vector<VkDescriptorSet> &&descriptor_sets) {
+        descriptor_sets_ = std::move(descriptor_sets);
+    }
+
+    // the value is copied so it may be a temporary
+    template <typename T>
+    void set_push_constants(T const &value) {
+        push_constants_.resize(sizeof(T));
+        std::memcpy(push_constants_.data(), &value, sizeof(T));
+    }
+
+    // the number of the workgroups which cover all the invocations
+    static uint32_t get_groups_count(uint32_t invocations_count, uint32_t local_size) {
+        return (invocations_count + local_size - 1) / local_size;
+    }
+
+    void execute(VkCommandBuffer command_buffer) override;
+};
@@ -0,0 +1,85 @@
+#include "frame_pacer.hpp"
+
+#include "utility/log.hpp"
+
+#include <algorithm>
+#include <thread>
+
+namespace {
+
+    constexpr double smoothing = 0.05;
+    constexpr size_t max_input_samples = 16;
+
+    double to_milliseconds(FramePacer::clock::duration duration) {
+        return std::chrono::duration<double, std::milli>(duration).count();
+    }
+
+    void smooth(double &value, double sample) {
+        value = value == 0.0 ? sample : value + (sample - value) * smoothing;
+    }
+
+} // namespace
+
+FramePacer::FramePacer(double target_frame_rate, clock::duration spin_threshold)
+    : spin_threshold_{spin_threshold} {
+    set_target_frame_rate(target_frame_rate);
+}
+
+void FramePacer::set_target_frame_rate(double target_frame_rate) {
+    if (target_frame_rate > 0.0) {
+        frame_period_ = std::chrono::duration_cast<clock::duration>(std::chrono::duration<double>(1.0 / target_frame_rate));
+        info_println("Limit frame rate to {} fps", target_frame_rate);
+    } else {
+        frame_period_ = clock::duration::zero();
+    }
+}
+
+void FramePacer::wait_frame() {
+    clock::time_point now = clock::now();
+    if (frame_period_ > clock::duration::zero()) {
+        // the missed frames are skipped instead of being caught up
+        if (now - frame_deadline_ > frame_period_) {
+            frame_deadline_ = now;
+        }
+        // the sleep is coarse and may oversleep so the rest of the interval is spinned
+        if (frame_deadline_ - now > spin_threshold_) {
+            std::this_thread::sleep_until(frame_deadline_ - spin_threshold_);
+        }
+        while ((now = clock::now()) < frame_deadline_) {
+            std::this_thread::yield();
+        }
+        frame_deadline_ += frame_period_;
+    }
+    if (frame_time_ != clock::time_point{}) {
+        smooth(statistics_.frame_time, to_milliseconds(now - frame_time_));
+    }
+    frame_time_ = now;
+}
+
+void FramePacer::mark_input() {
+    if (!input_time_) {
+        input_time_ = clock::now();
+    }
+}
+
+void FramePacer::mark_submitted(uint64_t present_id) {
+    if (!input_time_) {
+        return;
+    }
+    if (input_samples_.size() == max_input_samples) {
+        input_samples_.pop_front();
+    }
+    input_samples_.push_back(InputSample{.present_id = present_id, .input_time = *input_time_});
+    input_time_.reset();
+}
+
+void FramePacer::mark_presented(uint64_t present_id) {
+    clock::time_point now = clock::now();
+    while (!input_samples_.empty() && input_samples_.front().present_id <= present_id) {
+        double latency = to_milliseconds(now - input_samples_.front().input_time);
+        smooth(statistics_.input_latency, latency);
+        statistics_.max_input_latency = std::max(statistics_.max_input_latency, latency);
+        ++statistics_.latency_samples;
+        input_samples_.pop_front();
+    }
+}
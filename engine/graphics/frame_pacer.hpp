@@ -0,0 +1,54 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <optional>
+
+// limits the frame rate and measures the latency from the input to the presentation of the frame
+class FramePacer {
+  public:
+    using clock = std::chrono::steady_clock;
+
+    struct Statistics {
+        // smoothed values in milliseconds
+        double frame_time = 0.0;
+        double input_latency = 0.0;
+        double max_input_latency = 0.0;
+        uint64_t latency_samples = 0;
+    };
+
+  private:
+    struct InputSample {
+        uint64_t present_id;
+        clock::time_point input_time;
+    };
+
+    clock::duration frame_period_{};
+    clock::duration spin_threshold_;
+    clock::time_point frame_deadline_{};
+    clock::time_point frame_time_{};
+    std::optional<clock::time_point> input_time_;
+    std::deque<InputSample> input_samples_;
+    Statistics statistics_;
+
+  public:
+    explicit FramePacer(double target_frame_rate, clock::duration spin_threshold = std::chrono::milliseconds{1});
+
+    // zero rate disables the limitation
+    void set_target_frame_rate(double target_frame_rate);
+
+    // sleeps and then spins until the beginning of the next frame
+    void wait_frame();
+
+    // remembers the time of the first input which has not been submitted yet
+    void mark_input();
+
+    void mark_submitted(uint64_t present_id);
+
+    void mark_presented(uint64_t present_id);
+
+    Statistics const &get_statistics() const {
+        return statistics_;
+    }
+};
@@ -0,0 +1,189 @@
+#include "gpu_profiler.hpp"
+
+#include "graphics_error.hpp"
+
+#include <algorithm>
+
+GpuProfiler::GpuProfiler(DeviceContext const &device_context, std::shared_ptr<DeferredDeleter> deleter, bool enabled)
+    : device_{device_context.get_device()}
+    , deleter_{deleter}
+    , timestamp_period_{device_context.get_properties().limits.timestampPeriod} {
+    uint32_t valid_bits = device_context.get_graphics_qfm_properties().timestampValidBits;
+    timestamp_mask_ = valid_bits >= 64 ? ~uint64_t{0} : (uint64_t{1} << valid_bits) - 1;
+    enabled_ = enabled && valid_bits != 0 && device_context.get_properties().limits.timestampComputeAndGraphics == VK_TRUE;
+    if (enabled && !enabled_) {
+        info_println("GPU profiling is not supported by the graphics queue");
+    }
+    // all the supported features are enabled by the device context
+    pipeline_statistics_ = enabled_ && device_context.get_features().features.features.pipelineStatisticsQuery == VK_TRUE;
+}
+
+void GpuProfiler::set_images_count(uint32_t images_count) {
+    if (!enabled_) {
+        return;
+    }
+    // the pools of the previous images may be still written by the frames in flight
+    for (auto &image : images_) {
+        deleter_->retire(std::move(image.timestamp_pool));
+        deleter_->retire(std::move(image.statistics_pool));
+    }
+    images_.clear();
+    images_.resize(images_count);
+    for (auto &image : images_) {
+        image.timestamp_pool = std::make_unique<QueryPool>(QueryPool::make_timestamp_pool(device_, max_queries_count));
+        if (pipeline_statistics_) {
+            image.statistics_pool =
+                std::make_unique<QueryPool>(QueryPool::make_pipeline_statistics_pool(device_, max_statistics_queries_count));
+        }
+    }
+}
+
+void GpuProfiler::write_timestamp(VkCommandBuffer command_buffer, VkPipelineStageFlagBits stage, ImageQueries &image, uint32_t &query) {
+    query = image.queries_count++;
+    image.timestamp_pool->write_timestamp(command_buffer, stage, query);
+}
+
+size_t GpuProfiler::get_zone_index(std::string_view name, uint32_t depth) {
+    std::lock_guard lock{mutex_};
+    std::string key{name};
+    auto iter = zone_indices_.find(key);
+    if (iter != zone_indices_.end()) {
+        return iter->second;
+    }
+    size_t index = zones_.size();
+    zones_.push_back(ZoneSamples{.statistics = ZoneStatistics{.name = key, .depth = depth}});
+    zone_indices_.emplace(std::move(key), index);
+    return index;
+}
+
+void GpuProfiler::begin_commands(VkCommandBuffer command_buffer, size_t image_index) {
+    if (!enabled_) {
+        return;
+    }
+    ImageQueries &image = images_[image_index];
+    image.timestamp_pool->reset(command_buffer);
+    if (image.statistics_pool) {
+        image.statistics_pool->reset(command_buffer);
+    }
+    image.zones.clear();
+    image.open_zones.clear();
+    image.queries_count = 0;
+    image.statistics_count = 0;
+    image.submitted = false;
+    recording_images_[command_buffer] = image_index;
+    begin_zone(command_buffer, frame_zone);
+}
+
+void GpuProfiler::end_commands(VkCommandBuffer command_buffer) {
+    if (!enabled_) {
+        return;
+    }
+    ImageQueries &image = images_[recording_images_.at(command_buffer)];
+    while (!image.open_zones.empty()) {
+        end_zone(command_buffer);
+    }
+    recording_images_.erase(command_buffer);
+}
+
+void GpuProfiler::begin_zone(VkCommandBuffer command_buffer, std::string_view name) {
+    if (!enabled_) {
+        return;
+    }
+    ImageQueries &image = images_[recording_images_.at(command_buffer)];
+    // the zone is dropped if there are not enough queries for its beginning and ending
+    if (image.queries_count + 2 + image.open_zones.size() > max_queries_count) {
+        image.open_zones.push_back(std::nullopt);
+        return;
+    }
+    uint32_t depth = static_cast<uint32_t>(image.open_zones.size());
+    Zone zone{.statistics_index = get_zone_index(name, depth)};
+    write_timestamp(command_buffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, image, zone.begin_query);
+    // queries of the same type can not be nested so the statistics are measured for the passes only
+    if (image.statistics_pool && depth == 1 && image.statistics_count < max_statistics_queries_count) {
+        zone.statistics_query = image.statistics_count++;
+        image.statistics_pool->begin(command_buffer, *zone.statistics_query);
+    }
+    image.open_zones.push_back(image.zones.size());
+    image.zones.push_back(zone);
+}
+
+void GpuProfiler::end_zone(VkCommandBuffer command_buffer) {
+    if (!enabled_) {
+        return;
+    }
+    ImageQueries &image = images_[recording_images_.at(command_buffer)];
+    if (image.open_zones.empty()) {
+        raise_error("There is no open GPU zone to end.");
+    }
+    auto zone_index = image.open_zones.back();
+    image.open_zones.pop_back();
+    if (zone_index) {
+        Zone &zone = image.zones[*zone_index];
+        if (zone.statistics_query) {
+            image.statistics_pool->end(command_buffer, *zone.statistics_query);
+        }
+        write_timestamp(command_buffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, image, zone.end_query);
+    }
+}
+
+void GpuProfiler::collect(size_t image_index) {
+    if (!enabled_ || image_index >= images_.size()) {
+        return;
+    }
+    ImageQueries &image = images_[image_index];
+    if (!image.submitted || image.queries_count == 0) {
+        // the results are read the next time the image is used
+        image.submitted = true;
+        return;
+    }
+    auto timestamps = image.timestamp_pool->get_results(0, image.queries_count);
+    std::vector<std::optional<QueryPool::values_t>> statistics_values;
+    if (image.statistics_pool) {
+        statistics_values = image.statistics_pool->get_results(0, image.statistics_count);
+    }
+    std::lock_guard lock{mutex_};
+    for (auto const &zone : image.zones) {
+        auto const &begin = timestamps[zone.begin_query];
+        auto const &end = timestamps[zone.end_query];
+        if (!begin || !end) {
+            continue;
+        }
+        uint64_t ticks = ((end->front() & timestamp_mask_) - (begin->front() & timestamp_mask_)) & timestamp_mask_;
+        double milliseconds = static_cast<double>(ticks) * timestamp_period_ * 1e-6;
+        ZoneSamples &samples = zones_[zone.statistics_index];
+        ZoneStatistics &statistics = samples.statistics;
+        statistics.last = milliseconds;
+        statistics.min = statistics.samples == 0 ? milliseconds : std::min(statistics.min, milliseconds);
+        statistics.max = std::max(statistics.max, milliseconds);
+        ++statistics.samples;
+        samples.window.push_back(milliseconds);
+        samples.window_sum += milliseconds;
+        if (samples.window.size() > window_size) {
+            samples.window_sum -= samples.window.front();
+            samples.window.pop_front();
+        }
+        statistics.average = samples.window_sum / samples.window.size();
+        if (zone.statistics_query && statistics_values[*zone.statistics_query]) {
+            statistics.pipeline_statistics = QueryPool::to_pipeline_statistics(*statistics_values[*zone.statistics_query]);
+        }
+    }
+}
+
+std::vector<GpuProfiler::ZoneStatistics> GpuProfiler::get_statistics() const {
+    std::lock_guard lock{mutex_};
+    std::vector<ZoneStatistics> statistics;
+    statistics.reserve(zones_.size());
+    for (auto const &zone : zones_) {
+        statistics.push_back(zone.statistics);
+    }
+    return statistics;
+}
+
+std::optional<GpuProfiler::ZoneStatistics> GpuProfiler::get_zone_statistics(std::string_view name) const {
+    std::lock_guard lock{mutex_};
+    auto iter = zone_indices_.find(std::string{name});
+    if (iter == zone_indices_.end()) {
+        return std::nullopt;
+    }
+    return zones_[iter->second].statistics;
+}
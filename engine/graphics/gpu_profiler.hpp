@@ -0,0 +1,127 @@
+#pragma once
+
+#include "deferred_deleter.hpp"
+#include "device_context.hpp"
+#include "query_pool.hpp"
+
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+// measures GPU time and pipeline statistics of the named zones recorded into the command buffers of the swapchain images
+class GpuProfiler {
+  public:
+    struct ZoneStatistics {
+        std::string name;
+        uint32_t depth = 0;
+        // milliseconds, the average is computed over the last samples
+        double last = 0.0;
+        double average = 0.0;
+        double min = 0.0;
+        double max = 0.0;
+        uint64_t samples = 0;
+        // counters of the last frame, measured only for the passes which are the zones directly inside the frame zone
+        std::optional<PipelineStatistics> pipeline_statistics;
+    };
+
+    // ends the zone when leaves the scope
+    class ScopedZone {
+        GpuProfiler &profiler_;
+        VkCommandBuffer command_buffer_;
+
+      public:
+        ScopedZone(GpuProfiler &profiler, VkCommandBuffer command_buffer, std::string_view name)
+            : profiler_{profiler}
+            , command_buffer_{command_buffer} {
+            profiler_.begin_zone(command_buffer_, name);
+        }
+
+        ScopedZone(ScopedZone const &) = delete;
+        ScopedZone &operator=(ScopedZone const &) = delete;
+
+        ~ScopedZone() {
+            profiler_.end_zone(command_buffer_);
+        }
+    };
+
+    static constexpr uint32_t max_queries_count = 256;
+    static constexpr uint32_t max_statistics_queries_count = 32;
+    static constexpr size_t window_size = 128;
+    static constexpr char const *frame_zone = "frame";
+
+  private:
+    struct Zone {
+        size_t statistics_index;
+        uint32_t begin_query;
+        uint32_t end_query;
+        std::optional<uint32_t> statistics_query;
+    };
+
+    struct ImageQueries {
+        std::unique_ptr<QueryPool> timestamp_pool;
+        std::unique_ptr<QueryPool> statistics_pool;
+        std::vector<Zone> zones;
+        // indices of the open zones or empty values for the zones dropped because of lack of queries
+        std::vector<std::optional<size_t>> open_zones;
+        uint32_t queries_count = 0;
+        uint32_t statistics_count = 0;
+        // results are read only after the recorded commands have been submitted
+        bool submitted = false;
+    };
+
+    struct ZoneSamples {
+        ZoneStatistics statistics;
+        std::deque<double> window;
+        double window_sum = 0.0;
+    };
+
+    shared_ptr_of<VkDevice> device_;
+    std::shared_ptr<DeferredDeleter> deleter_;
+    double timestamp_period_;
+    uint64_t timestamp_mask_;
+    bool enabled_;
+    bool pipeline_statistics_;
+    std::vector<ImageQueries> images_;
+    std::unordered_map<VkCommandBuffer, size_t> recording_images_;
+    mutable std::mutex mutex_;
+    std::vector<ZoneSamples> zones_;
+    std::unordered_map<std::string, size_t> zone_indices_;
+
+    void write_timestamp(VkCommandBuffer command_buffer, VkPipelineStageFlagBits stage, ImageQueries &image, uint32_t &query);
+
+    size_t get_zone_index(std::string_view name, uint32_t depth);
+
+  public:
+    GpuProfiler(DeviceContext const &device_context, std::shared_ptr<DeferredDeleter> deleter, bool enabled);
+
+    bool is_enabled() const {
+        return enabled_;
+    }
+
+    bool is_pipeline_statistics_enabled() const {
+        return pipeline_statistics_;
+    }
+
+    void set_images_count(uint32_t images_count);
+
+    // resets the queries of the image and opens the frame zone, must be called outside of a render pass
+    void begin_commands(VkCommandBuffer command_buffer, size_t image_index);
+
+    void end_commands(VkCommandBuffer command_buffer);
+
+    void begin_zone(VkCommandBuffer command_buffer, std::string_view name);
+
+    void end_zone(VkCommandBuffer command_buffer);
+
+    // reads the results of the previous frame rendered to the image, must be called when the image is not in use
+    void collect(size_t image_index);
+
+    std::vector<ZoneStatistics> get_statistics() const;
+
+    std::optional<ZoneStatistics> get_zone_statistics(std::string_view name) const;
+};
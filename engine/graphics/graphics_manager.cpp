@@ -112,18 +112,34 @@ unique_ptr_of<VkSurfaceKHR> GraphicsManager::make_surface(shared_ptr_of<VkInstan
     });
 }
 
+unique_ptr_of<VkSurfaceKHR> GraphicsManager::make_headless_surface(shared_ptr_of<VkInstance> instance) {
+    auto create_surface =
+        reinterpret_cast<PFN_vkCreateHeadlessSurfaceEXT>(vkGetInstanceProcAddr(instance.get(), "vkCreateHeadlessSurfaceEXT"));
+    if (create_surface == nullptr) {
+        raise_error("Failed to load vkCreateHeadlessSurfaceEXT.");
+    }
+    VkHeadlessSurfaceCreateInfoEXT info{
+        .sType = VK_STRUCTURE_TYPE_HEADLESS_SURFACE_CREATE_INFO_EXT,
+    };
+    VkSurfaceKHR surface;
+    vk_assert(create_surface(instance.get(), &info, nullptr, &surface), "Failed to create headless surface.");
+    return unique_ptr_of<VkSurfaceKHR>(surface, [instance](VkSurfaceKHR surface) {
+        debug_println("delete surface");
+        vkDestroySurfaceKHR(instance.get(), surface, nullptr);
+    });
+}
+
 shared_ptr_of<VkDevice> GraphicsManager::make_device(VkPhysicalDevice phys_device,
                                                      std::span<VkDeviceQueueCreateInfo const> queue_infos,
-                                                     std::span<char const *const> extension_names) {
-    VkPhysicalDeviceFeatures features;
-    vkGetPhysicalDeviceFeatures(phys_device, &features);
+                                                     std::span<char const *const> extension_names,
+                                                     VkPhysicalDeviceFeatures2 const &features) {
     VkDeviceCreateInfo info{
         .sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO,
+        .pNext = &features,
         .queueCreateInfoCount = static_cast<uint32_t>(queue_infos.size()),
         .pQueueCreateInfos = queue_infos.data(),
         .enabledExtensionCount = static_cast<std::uint32_t>(extension_names.size()),
         .ppEnabledExtensionNames = extension_names.data(),
-        .pEnabledFeatures = &features,
     };
     VkDevice device;
     vk_assert(vkCreateDevice(phys_device, &info, nullptr, &device), "Failed to create a device.");
@@ -167,13 +183,19 @@ GraphicsManager::make_command_pool(shared_ptr_of<VkDevice> device, VkCommandPool
     });
 }
 
-unique_ptr_of<VkBuffer>
-GraphicsManager::make_buffer(shared_ptr_of<VkDevice> device, size_t size, VkBufferUsageFlags usage, VkSharingMode mode) {
+unique_ptr_of<VkBuffer> GraphicsManager::make_buffer(shared_ptr_of<VkDevice> device,
+                                                     size_t size,
+                                                     VkBufferUsageFlags usage,
+                                                     VkSharingMode mode,
+                                                     std::span<uint32_t const> qfm_indices) {
+    bool concurrent = mode == VK_SHARING_MODE_CONCURRENT;
     VkBufferCreateInfo info{
         .sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO,
         .size = size,
         .usage = usage,
         .sharingMode = mode,
+        .queueFamilyIndexCount = concurrent ? static_cast<uint32_t>(qfm_indices.size()) : 0,
+        .pQueueFamilyIndices = concurrent ? qfm_indices.data() : nullptr,
     };
     VkBuffer buffer;
     vk_assert(vkCreateBuffer(device.get(), &info, nullptr, &buffer), "Failed to create a buffer.");
@@ -291,6 +313,24 @@ unique_ptr_of<VkSemaphore> GraphicsManager::make_semaphore(shared_ptr_of<VkDevic
     });
 }
 
+unique_ptr_of<VkSemaphore> GraphicsManager::make_timeline_semaphore(shared_ptr_of<VkDevice> device, uint64_t initial_value) {
+    VkSemaphoreTypeCreateInfo type_info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO,
+        .semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE,
+        .initialValue = initial_value,
+    };
+    VkSemaphoreCreateInfo semaphore_info{
+        .sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO,
+        .pNext = &type_info,
+    };
+    VkSemaphore semaphore;
+    vk_assert(vkCreateSemaphore(device.get(), &semaphore_info, nullptr, &semaphore), "Failed to create a timeline semaphore.");
+    return unique_ptr_of<VkSemaphore>(semaphore, [device](VkSemaphore semaphore) {
+        debug_println("delete timeline semaphore");
+        vkDestroySemaphore(device.get(), semaphore, nullptr);
+    });
+}
+
 unique_ptr_of<VkPipelineLayout> GraphicsManager::make_pipeline_layout(shared_ptr_of<VkDevice> device,
                                                                       std::span<VkDescriptorSetLayout const> set_layouts,
                                                                       std::span<VkPushConstantRange const> push_constant_ranges) {
@@ -309,20 +349,88 @@ unique_ptr_of<VkPipelineLayout> GraphicsManager::make_pipeline_layout(shared_ptr
     });
 }
 
+unique_ptr_of<VkShaderModule> GraphicsManager::make_shader_module(shared_ptr_of<VkDevice> device, std::span<uint32_t const> code) {
+    VkShaderModuleCreateInfo info{
+        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
+        .codeSize = code.size_bytes(),
+        .pCode = code.data(),
+    };
+    VkShaderModule shader_module;
+    vk_assert(vkCreateShaderModule(device.get(), &info, nullptr, &shader_module), "Failed to create a shader module.");
+    return unique_ptr_of<VkShaderModule>(shader_module, [device](VkShaderModule shader_module) {
+        debug_println("delete shader module");
+        vkDestroyShaderModule(device.get(), shader_module, nullptr);
+    });
+}
+
+unique_ptr_of<VkPipelineCache> GraphicsManager::make_pipeline_cache(shared_ptr_of<VkDevice> device,
+                                                                   std::span<std::byte const> initial_data) {
+    VkPipelineCacheCreateInfo info{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO,
+        .initialDataSize = initial_data.size(),
+        .pInitialData = initial_data.data(),
+    };
+    VkPipelineCache pipeline_cache;
+    vk_assert(vkCreatePipelineCache(device.get(), &info, nullptr, &pipeline_cache), "Failed to create pipeline cache.");
+    return unique_ptr_of<VkPipelineCache>(pipeline_cache, [device](VkPipelineCache pipeline_cache) {
+        debug_println("delete pipeline cache");
+        vkDestroyPipelineCache(device.get(), pipeline_cache, nullptr);
+    });
+}
+
 unique_ptr_of<VkPipeline> GraphicsManager::make_pipeline(shared_ptr_of<VkDevice> device,
-                                                         VkGraphicsPipelineCreateInfo const &pipeline_info) {
+                                                         VkGraphicsPipelineCreateInfo const &pipeline_info,
+                                                         VkPipelineCache pipeline_cache) {
     VkPipeline pipeline;
-    vk_assert(vkCreateGraphicsPipelines(device.get(), nullptr, 1, &pipeline_info, nullptr, &pipeline), "Failed to create a pipeline.");
+    vk_assert(vkCreateGraphicsPipelines(device.get(), pipeline_cache, 1, &pipeline_info, nullptr, &pipeline),
+              "Failed to create a pipeline.");
     return unique_ptr_of<VkPipeline>(pipeline, [device](VkPipeline pipeline) {
         debug_println("delete pipeline");
         vkDestroyPipeline(device.get(), pipeline, nullptr);
     });
 }
 
+unique_ptr_of<VkPipeline> GraphicsManager::make_cached_pipeline(shared_ptr_of<VkDevice> device,
+                                                                VkGraphicsPipelineCreateInfo const &pipeline_info,
+                                                                VkPipelineCache pipeline_cache) {
+    VkPipeline pipeline;
+    VkResult result = vkCreateGraphicsPipelines(device.get(), pipeline_cache, 1, &pipeline_info, nullptr, &pipeline);
+    if (result == VK_PIPELINE_COMPILE_REQUIRED_EXT) {
+        return nullptr;
+    }
+    vk_assert(result, "Failed to create a cached pipeline.");
+    return unique_ptr_of<VkPipeline>(pipeline, [device](VkPipeline pipeline) {
+        debug_println("delete pipeline");
+        vkDestroyPipeline(device.get(), pipeline, nullptr);
+    });
+}
+
+unique_ptr_of<VkPipeline> GraphicsManager::make_compute_pipeline(shared_ptr_of<VkDevice> device,
+                                                                 VkComputePipelineCreateInfo const &pipeline_info,
+                                                                 VkPipelineCache pipeline_cache) {
+    VkPipeline pipeline;
+    vk_assert(vkCreateComputePipelines(device.get(), pipeline_cache, 1, &pipeline_info, nullptr, &pipeline),
+              "Failed to create a compute pipeline.");
+    return unique_ptr_of<VkPipeline>(pipeline, [device](VkPipeline pipeline) {
+        debug_println("delete compute pipeline");
+        vkDestroyPipeline(device.get(), pipeline, nullptr);
+    });
+}
+
 unique_ptr_of<VkDescriptorSetLayout>
-GraphicsManager::make_descriptor_set_layout(shared_ptr_of<VkDevice> device, std::span<VkDescriptorSetLayoutBinding const> bindings) {
+GraphicsManager::make_descriptor_set_layout(shared_ptr_of<VkDevice> device,
+                                            std::span<VkDescriptorSetLayoutBinding const> bindings,
+                                            VkDescriptorSetLayoutCreateFlags flags,
+                                            std::span<VkDescriptorBindingFlags const> binding_flags) {
+    VkDescriptorSetLayoutBindingFlagsCreateInfo flags_info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO,
+        .bindingCount = static_cast<uint32_t>(binding_flags.size()),
+        .pBindingFlags = binding_flags.data(),
+    };
     VkDescriptorSetLayoutCreateInfo info{
         .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO,
+        .pNext = binding_flags.empty() ? nullptr : &flags_info,
+        .flags = flags,
         .bindingCount = static_cast<uint32_t>(bindings.size()),
         .pBindings = bindings.data(),
     };
@@ -336,9 +444,11 @@ GraphicsManager::make_descriptor_set_layout(shared_ptr_of<VkDevice> device, std:
 
 unique_ptr_of<VkDescriptorPool> GraphicsManager::make_descriptor_pool(shared_ptr_of<VkDevice> device,
                                                                       uint32_t max_sets_count,
-                                                                      std::span<VkDescriptorPoolSize const> pool_sizes) {
+                                                                      std::span<VkDescriptorPoolSize const> pool_sizes,
+                                                                      VkDescriptorPoolCreateFlags flags) {
     VkDescriptorPoolCreateInfo info{
         .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO,
+        .flags = flags,
         .maxSets = max_sets_count,
         .poolSizeCount = static_cast<uint32_t>(pool_sizes.size()),
         .pPoolSizes = pool_sizes.data(),
@@ -351,6 +461,26 @@ unique_ptr_of<VkDescriptorPool> GraphicsManager::make_descriptor_pool(shared_ptr
     });
 }
 
+unique_ptr_of<VkDescriptorUpdateTemplate>
+GraphicsManager::make_descriptor_update_template(shared_ptr_of<VkDevice> device,
+                                                 VkDescriptorSetLayout set_layout,
+                                                 std::span<VkDescriptorUpdateTemplateEntry const> entries) {
+    VkDescriptorUpdateTemplateCreateInfo info{
+        .sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO,
+        .descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size()),
+        .pDescriptorUpdateEntries = entries.data(),
+        .templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET,
+        .descriptorSetLayout = set_layout,
+    };
+    VkDescriptorUpdateTemplate update_template;
+    vk_assert(vkCreateDescriptorUpdateTemplate(device.get(), &info, nullptr, &update_template),
+              "Failed to create a descriptor update template.");
+    return unique_ptr_of<VkDescriptorUpdateTemplate>(update_template, [device](VkDescriptorUpdateTemplate update_template) {
+        debug_println("delete descriptor update template");
+        vkDestroyDescriptorUpdateTemplate(device.get(), update_template, nullptr);
+    });
+}
+
 std::vector<VkDescriptorSet> GraphicsManager::allocate_descriptor_sets(shared_ptr_of<VkDevice> device,
                                                                        VkDescriptorPool pool,
                                                                        std::span<VkDescriptorSetLayout const> layouts) {
@@ -400,3 +530,12 @@ unique_ptr_of<VkSampler> GraphicsManager::make_sampler(shared_ptr_of<VkDevice> d
         vkDestroySampler(device.get(), sampler, nullptr);
     });
 }
+
+unique_ptr_of<VkQueryPool> GraphicsManager::make_query_pool(shared_ptr_of<VkDevice> device, VkQueryPoolCreateInfo const &info) {
+    VkQueryPool query_pool;
+    vk_assert(vkCreateQueryPool(device.get(), &info, nullptr, &query_pool), "Failed to create query pool.");
+    return unique_ptr_of<VkQueryPool>(query_pool, [device](VkQueryPool query_pool) {
+        debug_println("delete query pool");
+        vkDestroyQueryPool(device.get(), query_pool, nullptr);
+    });
+}
@@ -4,6 +4,7 @@
 
 #include <GLFW/glfw3.h>
 
+#include <cstddef>
 #include <span>
 #include <string_view>
 #include <vector>
@@ -17,9 +18,12 @@ class GraphicsManager {
 
     static unique_ptr_of<VkSurfaceKHR> make_surface(shared_ptr_of<VkInstance> instance, GLFWwindow *window);
 
+    static unique_ptr_of<VkSurfaceKHR> make_headless_surface(shared_ptr_of<VkInstance> instance);
+
     static shared_ptr_of<VkDevice> make_device(VkPhysicalDevice phys_device,
                                                std::span<VkDeviceQueueCreateInfo const> queue_infos,
-                                               std::span<char const *const> extension_names);
+                                               std::span<char const *const> extension_names,
+                                               VkPhysicalDeviceFeatures2 const &features);
 
     static unique_ptr_of<VkRenderPass> make_render_pass(shared_ptr_of<VkDevice> device, VkRenderPassCreateInfo const &info);
 
@@ -28,7 +32,12 @@ class GraphicsManager {
     static shared_ptr_of<VkCommandPool>
     make_command_pool(shared_ptr_of<VkDevice> device, VkCommandPoolCreateFlags create_flags, uint32_t qfm_index);
 
-    static unique_ptr_of<VkBuffer> make_buffer(shared_ptr_of<VkDevice> device, size_t size, VkBufferUsageFlags usage, VkSharingMode mode);
+    // the families are used by the concurrent sharing mode only
+    static unique_ptr_of<VkBuffer> make_buffer(shared_ptr_of<VkDevice> device,
+                                               size_t size,
+                                               VkBufferUsageFlags usage,
+                                               VkSharingMode mode,
+                                               std::span<uint32_t const> qfm_indices = {});
 
     static unique_ptr_of<VkCommandBuffer> make_command_buffer(shared_ptr_of<VkDevice> device, shared_ptr_of<VkCommandPool> command_pool);
 
@@ -47,17 +56,45 @@ class GraphicsManager {
 
     static unique_ptr_of<VkSemaphore> make_semaphore(shared_ptr_of<VkDevice> device);
 
+    // the counter of the semaphore starts from the initial value and is waited for and signaled with increasing values
+    static unique_ptr_of<VkSemaphore> make_timeline_semaphore(shared_ptr_of<VkDevice> device, uint64_t initial_value);
+
     static unique_ptr_of<VkPipelineLayout> make_pipeline_layout(shared_ptr_of<VkDevice> device,
                                                                 std::span<VkDescriptorSetLayout const> set_layouts,
                                                                 std::span<VkPushConstantRange const> push_constant_ranges);
 
-    static unique_ptr_of<VkPipeline> make_pipeline(shared_ptr_of<VkDevice> device, VkGraphicsPipelineCreateInfo const &pipeline_info);
+    // the code has to be aligned to the word boundary
+    static unique_ptr_of<VkShaderModule> make_shader_module(shared_ptr_of<VkDevice> device, std::span<uint32_t const> code);
+
+    static unique_ptr_of<VkPipelineCache> make_pipeline_cache(shared_ptr_of<VkDevice> device, std::span<std::byte const> initial_data);
+
+    static unique_ptr_of<VkPipeline>
+    make_pipeline(shared_ptr_of<VkDevice> device, VkGraphicsPipelineCreateInfo const &pipeline_info, VkPipelineCache pipeline_cache);
 
+    // returns null if the pipeline is not in the cache, the info has to fail on the required compilation
+    static unique_ptr_of<VkPipeline>
+    make_cached_pipeline(shared_ptr_of<VkDevice> device, VkGraphicsPipelineCreateInfo const &pipeline_info, VkPipelineCache pipeline_cache);
+
+    static unique_ptr_of<VkPipeline>
+    make_compute_pipeline(shared_ptr_of<VkDevice> device, VkComputePipelineCreateInfo const &pipeline_info, VkPipelineCache pipeline_cache);
+
+    // the binding flags are either empty or given for every binding
     static unique_ptr_of<VkDescriptorSetLayout> make_descriptor_set_layout(shared_ptr_of<VkDevice> device,
-                                                                           std::span<VkDescriptorSetLayoutBinding const> bindings);
+                                                                           std::span<VkDescriptorSetLayoutBinding const> bindings,
+                                                                           VkDescriptorSetLayoutCreateFlags flags = 0,
+                                                                           std::span<VkDescriptorBindingFlags const> binding_flags = {});
 
     static unique_ptr_of<VkDescriptorPool>
-    make_descriptor_pool(shared_ptr_of<VkDevice> device, uint32_t max_sets_count, std::span<VkDescriptorPoolSize const> pool_sizes);
+    make_descriptor_pool(shared_ptr_of<VkDevice> device,
+                         uint32_t max_sets_count,
+                         std::span<VkDescriptorPoolSize const> pool_sizes,
+                         VkDescriptorPoolCreateFlags flags = 0);
+
+    // the entries address the descriptors in the data passed to every update of the sets of the layout
+    static unique_ptr_of<VkDescriptorUpdateTemplate>
+    make_descriptor_update_template(shared_ptr_of<VkDevice> device,
+                                    VkDescriptorSetLayout set_layout,
+                                    std::span<VkDescriptorUpdateTemplateEntry const> entries);
 
     static std::vector<VkDescriptorSet>
     allocate_descriptor_sets(shared_ptr_of<VkDevice> device, VkDescriptorPool pool, std::span<VkDescriptorSetLayout const> layouts);
@@ -65,4 +102,6 @@ class GraphicsManager {
     static unique_ptr_of<VkImage> make_image(shared_ptr_of<VkDevice> device, VkImageCreateInfo const &info);
 
     static unique_ptr_of<VkSampler> make_sampler(shared_ptr_of<VkDevice> device, float anisotropy = 1.0f);
+
+    static unique_ptr_of<VkQueryPool> make_query_pool(shared_ptr_of<VkDevice> device, VkQueryPoolCreateInfo const &info);
 };
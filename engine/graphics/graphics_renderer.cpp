@@ -4,10 +4,16 @@
 #include "memory_list_allocator.hpp"
 #include "window_context.hpp"
 
+#include "utility/trace.hpp"
+
 #include <GLFW/glfw3.h>
 
 #include <algorithm>
 #include <array>
+#include <atomic>
+#include <exception>
+#include <limits>
+#include <thread>
 
 inline bool operator==(VkSurfaceFormatKHR left, VkSurfaceFormatKHR right) {
     return left.colorSpace == right.colorSpace && left.format == right.format;
@@ -35,6 +41,10 @@ namespace {
         }
     }
 
+    // the stages of the draws which may read the results of the compute work
+    VkPipelineStageFlags constexpr compute_wait_stages = VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT |
+                                                         VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+
 } // namespace
 
 GraphicsRenderer::GraphicsRenderer(WindowConfig const &info)
@@ -44,87 +54,363 @@ GraphicsRenderer::GraphicsRenderer(WindowConfig const &info)
 GraphicsRenderer::GraphicsRenderer(WindowConfig const &info, Config const &settings)
     : config_{settings}
     , instance_context_{info}
-    , device_context_{instance_context_.get_instance(), instance_context_.get_surface()}
+    , device_context_{instance_context_.get_instance(),
+                      instance_context_.get_surface(),
+                      config_.pipeline_cache_file,
+                      instance_context_.is_surface_maintenance_enabled()}
     , allocator_{std::make_shared<MemoryListAllocator>(device_context_.get_device(), device_context_.get_physical_device())}
+    , deleter_{std::make_shared<DeferredDeleter>()}
+    , shader_library_{device_context_}
+    , layout_cache_{device_context_.get_device()}
+    , descriptor_allocator_{std::make_shared<DescriptorAllocator>(device_context_.get_device())}
+    , gpu_profiler_{device_context_, deleter_, config_.gpu_profiling}
     , swapchain_context_{device_context_.get_device(), allocator_, get_swapchain_context_info()}
-    , swapchain_presenter_{device_context_.get_device(), device_context_.get_graphics_queue(), device_context_.get_present_queue()} {
-    auto window_ctx = WindowContext::get_window_context(instance_context_.get_window());
-    window_ctx->set_resize_callback(std::bind(&GraphicsRenderer::on_window_resized, this, std::placeholders::_1, std::placeholders::_2));
+    , swapchain_presenter_{device_context_.get_device(),
+                           device_context_.get_graphics_queue(),
+                           device_context_.get_present_queue(),
+                           config_.frames_in_flight,
+                           device_context_.is_present_wait_supported(),
+                           device_context_.is_present_fence_supported()}
+    , frame_pacer_{config_.target_frame_rate}
+    , pipeline_registry_{config_.pipeline_library && device_context_.is_pipeline_library_supported()}
+    , pipeline_compiler_{config_.pipeline_compiler_threads, &pipeline_registry_} {
+    int width = info.width, height = info.height;
+    if (auto window_ctx = get_window_context()) {
+        glfwGetFramebufferSize(instance_context_.get_window(), &width, &height);
+        window_ctx->set_resize_callback(
+            std::bind(&GraphicsRenderer::on_window_resized, this, std::placeholders::_1, std::placeholders::_2));
+    }
+    framebuffer_extent_ = VkExtent2D{.width = static_cast<uint32_t>(width), .height = static_cast<uint32_t>(height)};
+    swapchain_presenter_.set_update_frame_callback(
+        std::bind(&GraphicsRenderer::on_frame_updated, this, std::placeholders::_1, std::placeholders::_2));
+    pipeline_compiler_.set_ready_callback(std::bind(&GraphicsRenderer::update_commands, this));
+    for (uint32_t i = 0; i < swapchain_presenter_.get_frames_count(); ++i) {
+        frame_descriptor_allocators_.push_back(std::make_unique<DescriptorAllocator>(device_context_.get_device()));
+    }
+    if ((config_.bindless_images > 0 || config_.bindless_buffers > 0) && BindlessTable::is_supported(device_context_)) {
+        bindless_table_ = std::make_unique<BindlessTable>(device_context_, deleter_, config_.bindless_images, config_.bindless_buffers);
+    }
+    if (device_context_.get_features().vulkan12.timelineSemaphore == VK_TRUE) {
+        compute_queue_ = std::make_unique<ComputeQueue>(device_context_);
+    }
+    if (!config_.shader_directory.empty()) {
+        shader_watcher_ = std::make_unique<FileWatcher>(config_.shader_directory, ".spv", [this](std::filesystem::path const &path) {
+            if (shader_library_.reload(path)) {
+                request_frame();
+            }
+        });
+    }
 }
 
 GraphicsRenderer::~GraphicsRenderer() {
     wait_device();
+    swapchain_presenter_.wait_present_fences();
+    deleter_->clear();
+}
+
+uint64_t GraphicsRenderer::submit_compute() {
+    if (!compute_queue_) {
+        raise_error("Compute queue requires timeline semaphores.");
+    }
+    uint64_t value = compute_queue_->submit();
+    if (value > 0) {
+        swapchain_presenter_.add_wait_semaphore(compute_queue_->get_semaphore(), value, compute_wait_stages);
+    }
+    return value;
 }
 
 void GraphicsRenderer::run() {
-    int width, height;
-    glfwGetWindowSize(instance_context_.get_window(), &width, &height);
-    on_window_resized(width, height);
-    while (!glfwWindowShouldClose(instance_context_.get_window())) {
-        glfwPollEvents();
-        // draw frame
-        swapchain_presenter_.submit_and_present(swapchain_context_.get_swapchain(), swapchain_context_.get_image());
+    if (instance_context_.get_window() == nullptr) {
+        run_headless();
+    } else if (config_.threaded_rendering) {
+        run_threaded();
+    } else {
+        while (is_running()) {
+            if (config_.render_on_demand && !is_frame_requested()) {
+                // nothing has changed since the last frame so the thread sleeps until an event
+                glfwWaitEventsTimeout(config_.idle_timeout);
+                continue;
+            }
+            pace_frame();
+            glfwPollEvents();
+            if (!render_frame()) {
+                // the window is minimized so there is nothing to draw until the next event
+                glfwWaitEvents();
+            }
+        }
     }
     wait_device();
+    swapchain_presenter_.wait_present_fences();
+    deleter_->clear();
+    // the cache only speeds up the next launch so its failure must not fail the shutdown
+    try {
+        device_context_.save_pipeline_cache();
+    } catch (std::exception const &ex) {
+        error_println("{}", ex.what());
+    }
+}
+
+void GraphicsRenderer::run_threaded() {
+    GLFWwindow *window = instance_context_.get_window();
+    WindowContext *window_ctx = WindowContext::get_window_context(window);
+    window_ctx->set_deferred_events(true);
+    std::atomic_bool rendering{true};
+    std::exception_ptr render_error;
+    std::thread render_thread{[this, window_ctx, &rendering, &render_error]() {
+        trace_thread_name("render");
+        try {
+            while (rendering) {
+                if (config_.render_on_demand && !is_frame_requested()) {
+                    window_ctx->wait_events();
+                    window_ctx->dispatch_events();
+                    continue;
+                }
+                pace_frame();
+                // events polled since the previous frame are delivered in a batch
+                window_ctx->dispatch_events();
+                if (!render_frame()) {
+                    window_ctx->wait_events();
+                }
+            }
+        } catch (...) {
+            render_error = std::current_exception();
+        }
+        rendering = false;
+        glfwPostEmptyEvent();
+    }};
+    // the main thread only pumps window events to the render thread
+    while (rendering) {
+        glfwWaitEvents();
+        if (!is_running()) {
+            rendering = false;
+            window_ctx->post_empty_event();
+        }
+    }
+    render_thread.join();
+    window_ctx->set_deferred_events(false);
+    if (render_error) {
+        std::rethrow_exception(render_error);
+    }
+}
+
+void GraphicsRenderer::run_headless() {
+    // there are no window events so frames are rendered continuously until stopped
+    while (!stop_requested_) {
+        pace_frame();
+        render_frame();
+    }
+}
+
+void GraphicsRenderer::stop() {
+    stop_requested_ = true;
+    if (auto window_ctx = get_window_context()) {
+        window_ctx->post_empty_event();
+        glfwPostEmptyEvent();
+    }
+}
+
+bool GraphicsRenderer::is_running() const {
+    GLFWwindow *window = instance_context_.get_window();
+    return !stop_requested_ && (window == nullptr || !glfwWindowShouldClose(window));
+}
+
+WindowContext *GraphicsRenderer::get_window_context() const {
+    return WindowContext::get_window_context(instance_context_.get_window());
+}
+
+void GraphicsRenderer::pace_frame() {
+    // waiting happens before the input is processed so the frame is rendered with the latest input
+    frame_pacer_.wait_frame();
+    if (config_.max_queued_presents > 0) {
+        uint64_t present_id = swapchain_presenter_.wait_queued_presents(swapchain_context_, config_.max_queued_presents);
+        if (present_id != 0) {
+            frame_pacer_.mark_presented(present_id);
+        }
+    }
+}
+
+bool GraphicsRenderer::render_frame() {
+    // resize events are coalesced to a single recreation per frame
+    if (swapchain_outdated_ && !recreate_swapchain()) {
+        return false;
+    }
+    // requests which come while the frame is drawn are rendered in the next frame
+    frame_requested_ = false;
+    if (uint64_t shaders_version = shader_library_.get_version(); shaders_version != shaders_version_) {
+        shaders_version_ = shaders_version;
+        // new pipelines are compiled in the background and replace the old ones when the commands are recorded again
+        if (shaders_reloaded_) {
+            shaders_reloaded_();
+        }
+    }
+    {
+        trace_zone("render_frame");
+        draw_frame();
+    }
+    // events of the threads are moved out of their buffers once per frame so the buffers never overflow
+    trace_flush();
+    return true;
+}
+
+void GraphicsRenderer::request_frame() {
+    frame_requested_ = true;
+    // wakes up the thread waiting for events
+    if (auto window_ctx = get_window_context()) {
+        if (config_.threaded_rendering) {
+            window_ctx->post_empty_event();
+        } else {
+            glfwPostEmptyEvent();
+        }
+    }
+}
+
+void GraphicsRenderer::set_animating(bool animating) {
+    animating_ = animating;
+    if (animating) {
+        request_frame();
+    }
+}
+
+bool GraphicsRenderer::is_frame_requested() const {
+    return frame_requested_ || animating_ || swapchain_outdated_;
+}
+
+// input callbacks are wrapped to request a frame and measure the latency to the presentation
+template <typename callback_t>
+callback_t GraphicsRenderer::wrap_input_callback(callback_t const &callback) {
+    if (!callback) {
+        return callback;
+    }
+    return [this, callback](auto... args) {
+        frame_pacer_.mark_input();
+        frame_requested_ = true;
+        callback(args...);
+    };
 }
 
 void GraphicsRenderer::set_cursor_callback(WindowConfig::cursor_t const &callback) {
-    WindowContext::get_window_context(instance_context_.get_window())->set_cursor_callback(callback);
+    if (auto window_ctx = get_window_context()) {
+        window_ctx->set_cursor_callback(wrap_input_callback(callback));
+    }
 }
 
 void GraphicsRenderer::set_keyboard_callback(WindowConfig::keyboard_t const &callback) {
-    WindowContext::get_window_context(instance_context_.get_window())->set_keyboard_callback(callback);
+    if (auto window_ctx = get_window_context()) {
+        window_ctx->set_keyboard_callback(wrap_input_callback(callback));
+    }
 }
 
 void GraphicsRenderer::set_mouse_button_callback(WindowConfig::mouse_button_t const &callback) {
-    WindowContext::get_window_context(instance_context_.get_window())->set_mouse_button_callback(callback);
+    if (auto window_ctx = get_window_context()) {
+        window_ctx->set_mouse_button_callback(wrap_input_callback(callback));
+    }
 }
 
 void GraphicsRenderer::set_mouse_scroll_callback(WindowConfig::mouse_scroll_t const &callback) {
-    WindowContext::get_window_context(instance_context_.get_window())->set_mouse_scroll_callback(callback);
+    if (auto window_ctx = get_window_context()) {
+        window_ctx->set_mouse_scroll_callback(wrap_input_callback(callback));
+    }
 }
 
 void GraphicsRenderer::on_window_resized(int width, int height) {
-    wait_device();
-    if (width == 0 || height == 0) {
+    framebuffer_extent_ = VkExtent2D{.width = static_cast<uint32_t>(width), .height = static_cast<uint32_t>(height)};
+    swapchain_outdated_ = true;
+}
+
+void GraphicsRenderer::on_frame_updated(size_t frame_index, size_t image_index) {
+    // the image is not in use anymore so the queries of its previous frame are completed
+    gpu_profiler_.collect(image_index);
+    // the fence of the frame slot has been waited for so its descriptor sets are not in use anymore
+    frame_index_ = frame_index;
+    frame_descriptor_allocators_[frame_index_]->reset();
+    if (update_frame_) {
+        update_frame_(frame_index, image_index);
+    }
+    // recorded after the callback which may have written the sets bound by the image
+    if (image_commands_versions_[image_index] != commands_version_) {
+        record_command_buffer(static_cast<uint32_t>(image_index));
+    }
+}
+
+bool GraphicsRenderer::recreate_swapchain() {
+    trace_zone("recreate_swapchain");
+    VkExtent2D extent = get_surface_extent();
+    if (extent.width == 0 || extent.height == 0) {
         // there is no need to recreate swapchain and set command buffers
-        return;
+        return false;
+    }
+    // old resources are retired and destroyed when the frames in flight are completed
+    swapchain_context_.update_extent(extent, *deleter_);
+    if (swapchain_presenter_.is_present_fence_enabled()) {
+        // the frames are completed after their presents so the old swapchain is destroyed without a wait
+        swapchain_context_.retire_swapchains(*deleter_);
     }
-    VkSurfaceCapabilitiesKHR surface_capabilities = get_surface_capabilities();
-    swapchain_context_.update_extent(surface_capabilities.currentExtent, device_context_.get_graphics_queue());
+    gpu_profiler_.set_images_count(swapchain_context_.get_images_count());
     if (context_changed_) {
         context_changed_(Context{
             .render_pass = swapchain_context_.get_render_pass(),
-            .surface_extent = surface_capabilities.currentExtent,
+            .render_pass_key = swapchain_context_.get_render_pass_key(),
+            .surface_extent = extent,
             .images_count = swapchain_context_.get_images_count(),
         });
     }
     set_command_buffers();
+    swapchain_outdated_ = false;
+    return true;
 }
 
-void GraphicsRenderer::update_render_pass() {
-    wait_device();
-    int width, height;
-    glfwGetFramebufferSize(instance_context_.get_window(), &width, &height);
-    if (width == 0 || height == 0) {
-        return;
+void GraphicsRenderer::draw_frame() {
+    uint64_t submitted_frame = swapchain_presenter_.get_submitted_frame();
+    if (!swapchain_presenter_.submit_and_present(swapchain_context_)) {
+        swapchain_outdated_ = true;
+    } else if (swapchain_context_.has_retired_swapchains()) {
+        // without the present fences the presents to the old swapchains are known to be complete only when the present
+        // queue is idle, they are queued before the first successful one to the new swapchain
+        vk_assert(vkQueueWaitIdle(device_context_.get_present_queue()), "Failed to wait for the present queue.");
+        swapchain_context_.release_retired_swapchains();
     }
-    set_command_buffers();
+    if (submitted_frame != swapchain_presenter_.get_submitted_frame()) {
+        uint64_t present_id = swapchain_presenter_.get_present_id();
+        frame_pacer_.mark_submitted(present_id);
+        if (!swapchain_presenter_.is_present_wait_enabled() || config_.max_queued_presents == 0) {
+            // without present wait the latency is measured until the image is queued for presentation
+            frame_pacer_.mark_presented(present_id);
+        }
+    }
+    deleter_->update(swapchain_presenter_.get_submitted_frame(), swapchain_presenter_.get_completed_frame());
+}
+
+void GraphicsRenderer::update_render_pass() {
+    update_commands();
+}
+
+void GraphicsRenderer::update_commands() {
+    ++commands_version_;
+    request_frame();
 }
 
 void GraphicsRenderer::set_command_buffers() {
+    uint32_t images_count = swapchain_context_.get_images_count();
+    image_commands_versions_.resize(images_count);
+    for (uint32_t image_index = 0; image_index < images_count; ++image_index) {
+        record_command_buffer(image_index);
+    }
+}
+
+void GraphicsRenderer::record_command_buffer(uint32_t image_index) {
+    // the version is read before the recording so the later update is not missed
+    image_commands_versions_[image_index] = commands_version_;
+    ImageRenderer renderer = swapchain_context_.get_image_renderer(image_index);
+    VkCommandBuffer command_buffer = renderer.begin();
+    // queries are reset outside of the render pass
+    gpu_profiler_.begin_commands(command_buffer, image_index);
+    renderer.begin_render_pass();
     if (update_command_) {
-        uint32_t index = 0;
-        for (auto &renderer : swapchain_context_.get_image_renderers()) {
-            update_command_(renderer.begin_render_pass(), index++);
-            renderer.end_render_pass();
-        }
-    } else {
-        for (auto &renderer : swapchain_context_.get_image_renderers()) {
-            renderer.begin_render_pass();
-            renderer.end_render_pass();
-        }
+        update_command_(command_buffer, image_index);
     }
+    renderer.end_render_pass();
+    gpu_profiler_.end_commands(command_buffer);
+    renderer.end();
 }
 
 VkSurfaceCapabilitiesKHR GraphicsRenderer::get_surface_capabilities() const {
@@ -133,24 +419,57 @@ VkSurfaceCapabilitiesKHR GraphicsRenderer::get_surface_capabilities() const {
     return capabilities;
 }
 
+VkExtent2D GraphicsRenderer::get_surface_extent() const {
+    if (instance_context_.get_surface() == nullptr) {
+        return framebuffer_extent_;
+    }
+    VkSurfaceCapabilitiesKHR capabilities = get_surface_capabilities();
+    if (capabilities.currentExtent.width != std::numeric_limits<uint32_t>::max()) {
+        return capabilities.currentExtent;
+    }
+    // the extent is defined by the swapchain, window size is not queried since it's allowed on the main thread only
+    return VkExtent2D{
+        .width = minmax(capabilities.minImageExtent.width, framebuffer_extent_.width, capabilities.maxImageExtent.width),
+        .height = minmax(capabilities.minImageExtent.height, framebuffer_extent_.height, capabilities.maxImageExtent.height),
+    };
+}
+
 void GraphicsRenderer::wait_device() const {
     vk_assert(vkDeviceWaitIdle(device_context_.get_device().get()), "Failed to wait idles.");
 }
 
 SwapchainContext::Info GraphicsRenderer::get_swapchain_context_info() const {
-    VkSurfaceCapabilitiesKHR surface_capabilities = get_surface_capabilities();
     SwapchainContext::Info info;
-    info.swapchain_info = {
-        .surface = instance_context_.get_surface(),
-        .surface_format = get_supported_surface_format(),
-        .present_mode = get_supported_present_mode(),
-        .pre_transform = surface_capabilities.currentTransform,
-        .composite_alpha = config_.composite_alpha,
-        .image_usage = config_.image_usage,
-        .images_count = std::min(surface_capabilities.maxImageCount, surface_capabilities.minImageCount + 1),
-        .graphics_qfm = device_context_.get_graphics_qfm(),
-        .present_qfm = device_context_.get_present_qfm(),
-    };
+    if (instance_context_.get_surface() == nullptr) {
+        // offscreen images are not held by a presentation engine so one image per frame in flight is enough
+        info.swapchain_info = {
+            .surface = nullptr,
+            .surface_format = config_.surface_format,
+            .present_mode = config_.default_present_mode,
+            .pre_transform = VK_SURFACE_TRANSFORM_IDENTITY_BIT_KHR,
+            .composite_alpha = config_.composite_alpha,
+            .image_usage = config_.image_usage | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+            .images_count = std::clamp(config_.frames_in_flight, 1u, SwapchainPresenter::max_frames_count),
+            .graphics_qfm = device_context_.get_graphics_qfm(),
+            .present_qfm = device_context_.get_present_qfm(),
+        };
+    } else {
+        VkSurfaceCapabilitiesKHR surface_capabilities = get_surface_capabilities();
+        info.swapchain_info = {
+            .surface = instance_context_.get_surface(),
+            .surface_format = get_supported_surface_format(),
+            .present_mode = get_supported_present_mode(),
+            .pre_transform = surface_capabilities.currentTransform,
+            .composite_alpha = config_.composite_alpha,
+            .image_usage = config_.image_usage,
+            // zero maximum means there is no limit on the images count
+            .images_count = surface_capabilities.maxImageCount == 0
+                                ? surface_capabilities.minImageCount + 1
+                                : std::min(surface_capabilities.maxImageCount, surface_capabilities.minImageCount + 1),
+            .graphics_qfm = device_context_.get_graphics_qfm(),
+            .present_qfm = device_context_.get_present_qfm(),
+        };
+    }
     if (config_.depth_buffering) {
         info.depth_info = {
             .depth_tiling = VK_IMAGE_TILING_OPTIMAL,
@@ -1,12 +1,28 @@
 #pragma once
 
 #include "allocator_interface.hpp"
+#include "bindless_table.hpp"
+#include "compute_queue.hpp"
+#include "deferred_deleter.hpp"
+#include "descriptor_allocator.hpp"
 #include "device_context.hpp"
+#include "frame_pacer.hpp"
+#include "gpu_profiler.hpp"
 #include "instance_context.hpp"
+#include "layout_cache.hpp"
+#include "pipeline_compiler.hpp"
+#include "shader_library.hpp"
 #include "swapchain_context.hpp"
 #include "swapchain_presenter.hpp"
 #include "window_config.hpp"
 
+#include "utility/file_watcher.hpp"
+
+#include <atomic>
+#include <string>
+
+class WindowContext;
+
 class GraphicsRenderer {
   public:
     struct Config {
@@ -19,16 +35,43 @@ class GraphicsRenderer {
         VkImageUsageFlags image_usage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
         VkCompositeAlphaFlagBitsKHR composite_alpha = VK_COMPOSITE_ALPHA_OPAQUE_BIT_KHR;
         bool depth_buffering = false;
+        uint32_t frames_in_flight = 2;
+        // the main thread only polls window events while a separate thread renders frames
+        bool threaded_rendering = false;
+        // zero rate does not limit frames
+        double target_frame_rate = 0.0;
+        // bounds the frames waiting for presentation when present wait is supported, zero disables the waiting
+        uint32_t max_queued_presents = 1;
+        // frames are rendered only when requested, on input or while animating
+        bool render_on_demand = false;
+        // seconds to wait for events while idle
+        double idle_timeout = 0.5;
+        // GPU time of the frame and the named zones is measured with timestamp queries
+        bool gpu_profiling = false;
+        // compiled pipelines are kept in the file between launches, empty name disables the persistence
+        std::string pipeline_cache_file = "pipeline_cache.bin";
+        // zero means the number of the hardware threads except the calling one
+        uint32_t pipeline_compiler_threads = 0;
+        // new pipelines are fast linked from the cached parts and optimized in the background when supported
+        bool pipeline_library = true;
+        // changed SPIR-V files of the directory are reloaded by the shader library, empty path disables the watching
+        std::filesystem::path shader_directory;
+        // sizes of the bindless table created when descriptor indexing is supported, zero counts disable it
+        uint32_t bindless_images = 4096;
+        uint32_t bindless_buffers = 1024;
     };
 
     struct Context {
         VkRenderPass render_pass;
+        // render passes with equal keys are compatible with the same pipelines
+        uint64_t render_pass_key;
         VkExtent2D surface_extent;
         uint32_t images_count;
     };
 
     using context_changed_t = std::function<void(Context const &)>;
     using update_command_t = std::function<void(VkCommandBuffer, size_t)>;
+    using shaders_reloaded_t = std::function<void()>;
 
     explicit GraphicsRenderer(WindowConfig const &info);
 
@@ -38,6 +81,9 @@ class GraphicsRenderer {
 
     void run();
 
+    // finishes the run loop after the current frame, may be called from any thread
+    void stop();
+
     DeviceContext const &get_device_context() const {
         return device_context_;
     }
@@ -46,6 +92,69 @@ class GraphicsRenderer {
         return allocator_;
     }
 
+    std::shared_ptr<DeferredDeleter> const &get_deleter() const {
+        return deleter_;
+    }
+
+    GpuProfiler &get_gpu_profiler() {
+        return gpu_profiler_;
+    }
+
+    GpuProfiler const &get_gpu_profiler() const {
+        return gpu_profiler_;
+    }
+
+    // compiled pipelines trigger the update of the command buffers
+    PipelineCompiler &get_pipeline_compiler() {
+        return pipeline_compiler_;
+    }
+
+    PipelineRegistry &get_pipeline_registry() {
+        return pipeline_registry_;
+    }
+
+    ShaderLibrary &get_shader_library() {
+        return shader_library_;
+    }
+
+    // pipelines and descriptor sets reflected from the shaders share their layouts
+    LayoutCache &get_layout_cache() {
+        return layout_cache_;
+    }
+
+    // the sets live as long as the allocator, e.g. the ones bound by the recorded command buffers
+    std::shared_ptr<DescriptorAllocator> const &get_descriptor_allocator() const {
+        return descriptor_allocator_;
+    }
+
+    // the sets are valid until the frame slot is reused so they suit the work submitted every frame, e.g. the compute
+    // dispatches, but not the command buffers of the images which are recorded once
+    DescriptorAllocator &get_frame_descriptor_allocator() {
+        return *frame_descriptor_allocators_[frame_index_];
+    }
+
+    // null if the device has no descriptor indexing or the table is disabled
+    BindlessTable *get_bindless_table() {
+        return bindless_table_.get();
+    }
+
+    // null if the device has no timeline semaphores
+    ComputeQueue *get_compute_queue() {
+        return compute_queue_.get();
+    }
+
+    // submits the commands added to the compute queue, the draws of the next frame wait for their results,
+    // called by the thread rendering the frames, e.g. in the update frame callback
+    uint64_t submit_compute();
+
+    uint64_t get_submitted_frames() const {
+        return swapchain_presenter_.get_submitted_frame();
+    }
+
+    FramePacer::Statistics const &get_frame_statistics() const {
+        return frame_pacer_.get_statistics();
+    }
+
     void set_context_changed_callback(context_changed_t const &callback) {
         context_changed_ = callback;
     }
@@ -54,8 +163,15 @@ class GraphicsRenderer {
         update_command_ = callback;
     }
 
+    // called when the image is not in use anymore and before its command buffer is recorded again, so the callback
+    // may write the descriptor sets bound by the image, e.g. by DescriptorSet::update, and call update_commands
     void set_update_frame_callback(SwapchainPresenter::update_frame_t const &callback) {
-        swapchain_presenter_.set_update_frame_callback(callback);
+        update_frame_ = callback;
+    }
+
+    // called before the frame when the shaders of the library have been reloaded
+    void set_shaders_reloaded_callback(shaders_reloaded_t const &callback) {
+        shaders_reloaded_ = callback;
     }
 
     void set_cursor_callback(WindowConfig::cursor_t const &callback);
@@ -66,15 +182,53 @@ class GraphicsRenderer {
 
     void set_mouse_scroll_callback(WindowConfig::mouse_scroll_t const &callback);
 
+    // the commands are recorded again at the frame boundary so the device is not waited for
     void update_render_pass();
 
+    // command buffers are recorded again before their images are rendered next time, may be called from any thread
+    void update_commands();
+
+    // marks the frame dirty so it's rendered in the on demand mode, may be called from any thread
+    void request_frame();
+
+    // frames are rendered continuously while animating in the on demand mode
+    void set_animating(bool animating);
+
   private:
     void on_window_resized(int width, int height);
 
+    void on_frame_updated(size_t frame_index, size_t image_index);
+
+    void run_threaded();
+
+    void run_headless();
+
+    bool is_running() const;
+
+    // returns null in the headless mode
+    WindowContext *get_window_context() const;
+
+    void pace_frame();
+
+    bool is_frame_requested() const;
+
+    template <typename callback_t>
+    callback_t wrap_input_callback(callback_t const &callback);
+
+    bool render_frame();
+
+    bool recreate_swapchain();
+
+    void draw_frame();
+
     void set_command_buffers();
 
+    void record_command_buffer(uint32_t image_index);
+
     VkSurfaceCapabilitiesKHR get_surface_capabilities() const;
 
+    VkExtent2D get_surface_extent() const;
+
     void wait_device() const;
 
     SwapchainContext::Info get_swapchain_context_info() const;
@@ -89,8 +243,34 @@ class GraphicsRenderer {
     InstanceContext instance_context_;
     DeviceContext device_context_;
     std::shared_ptr<AllocatorInterface> allocator_;
+    std::shared_ptr<DeferredDeleter> deleter_;
+    ShaderLibrary shader_library_;
+    LayoutCache layout_cache_;
+    std::unique_ptr<ComputeQueue> compute_queue_;
+    std::shared_ptr<DescriptorAllocator> descriptor_allocator_;
+    // every frame slot allocates from its own pools which are reset when the slot is reused
+    std::vector<std::unique_ptr<DescriptorAllocator>> frame_descriptor_allocators_;
+    size_t frame_index_ = 0;
+    std::unique_ptr<BindlessTable> bindless_table_;
+    GpuProfiler gpu_profiler_;
     SwapchainContext swapchain_context_;
     SwapchainPresenter swapchain_presenter_;
+    FramePacer frame_pacer_;
     context_changed_t context_changed_;
     update_command_t update_command_;
+    SwapchainPresenter::update_frame_t update_frame_;
+    shaders_reloaded_t shaders_reloaded_;
+    uint64_t shaders_version_ = 0;
+    VkExtent2D framebuffer_extent_;
+    bool swapchain_outdated_ = true;
+    std::atomic_bool frame_requested_{true};
+    std::atomic_bool animating_{false};
+    std::atomic_bool stop_requested_{false};
+    std::atomic<uint64_t> commands_version_{0};
+    // version of the commands recorded to the command buffer of every image
+    std::vector<uint64_t> image_commands_versions_;
+    PipelineRegistry pipeline_registry_;
+    // destroyed first since their threads call back the renderer
+    PipelineCompiler pipeline_compiler_;
+    std::unique_ptr<FileWatcher> shader_watcher_;
 };
\ No newline at end of file
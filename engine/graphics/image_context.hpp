@@ -1,15 +1,30 @@
 #pragma once
 
 #include "graphics_types.hpp"
+#include "offscreen_texture.hpp"
 
 class ImageContext {
+    VkImage image_ = nullptr;
+    // image is owned by the swapchain unless it's an offscreen one
+    std::unique_ptr<OffscreenTexture> offscreen_texture_;
     unique_ptr_of<VkImageView> image_view_;
     unique_ptr_of<VkFramebuffer> framebuffer_;
-    unique_ptr_of<VkSemaphore> submit_semaphore_;
-    unique_ptr_of<VkSemaphore> present_semaphore_;
     unique_ptr_of<VkCommandBuffer> command_buffer_;
 
   public:
+    VkImage get_image() const {
+        return image_;
+    }
+
+    void set_image(VkImage image) {
+        image_ = image;
+    }
+
+    void set_offscreen_texture(std::unique_ptr<OffscreenTexture> texture) {
+        image_ = texture->get_image();
+        offscreen_texture_.swap(texture);
+    }
+
     VkImageView get_image_view() const {
         return image_view_.get();
     }
@@ -26,22 +41,6 @@ class ImageContext {
         framebuffer_.swap(framebuffer);
     }
 
-    VkSemaphore get_submit_semaphore() const {
-        return submit_semaphore_.get();
-    }
-
-    void set_submit_semaphore(unique_ptr_of<VkSemaphore> semaphore) {
-        submit_semaphore_.swap(semaphore);
-    }
-
-    VkSemaphore get_present_semaphore() const {
-        return present_semaphore_.get();
-    }
-
-    void set_present_semaphore(unique_ptr_of<VkSemaphore> semaphore) {
-        present_semaphore_.swap(semaphore);
-    }
-
     VkCommandBuffer get_command_buffer() const {
         return command_buffer_.get();
     }
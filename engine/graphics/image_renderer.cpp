@@ -2,7 +2,7 @@
 
 #include "graphics_error.hpp"
 
-VkCommandBuffer ImageRenderer::begin_render_pass() {
+VkCommandBuffer ImageRenderer::begin() {
     vk_assert(vkResetCommandBuffer(command_buffer_, 0), "Failed to reset the command buffer.");
     {
         VkCommandBufferBeginInfo begin_info{
@@ -12,22 +12,36 @@ VkCommandBuffer ImageRenderer::begin_render_pass() {
         };
         vk_assert(vkBeginCommandBuffer(command_buffer_, &begin_info), "Failed to begin the command buffer.");
     }
-    {
-        VkClearValue clear_value{.color = VkClearColorValue{0, 0, 0, 1}};
-        VkRenderPassBeginInfo begin_info{
-            .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
-            .renderPass = render_pass_,
-            .framebuffer = framebuffer_,
-            .renderArea = rect_,
-            .clearValueCount = static_cast<uint32_t>(clear_values_.size()),
-            .pClearValues = clear_values_.data(),
-        };
-        vkCmdBeginRenderPass(command_buffer_, &begin_info, VkSubpassContents::VK_SUBPASS_CONTENTS_INLINE);
-    }
+    return command_buffer_;
+}
+
+VkCommandBuffer ImageRenderer::begin_render_pass() {
+    VkRenderPassBeginInfo begin_info{
+        .sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO,
+        .renderPass = render_pass_,
+        .framebuffer = framebuffer_,
+        .renderArea = rect_,
+        .clearValueCount = static_cast<uint32_t>(clear_values_.size()),
+        .pClearValues = clear_values_.data(),
+    };
+    vkCmdBeginRenderPass(command_buffer_, &begin_info, VkSubpassContents::VK_SUBPASS_CONTENTS_INLINE);
+    VkViewport viewport{
+        .x = 0,
+        .y = 0,
+        .width = static_cast<float>(rect_.extent.width),
+        .height = static_cast<float>(rect_.extent.height),
+        .minDepth = 0,
+        .maxDepth = 1,
+    };
+    vkCmdSetViewport(command_buffer_, 0, 1, &viewport);
+    vkCmdSetScissor(command_buffer_, 0, 1, &rect_);
     return command_buffer_;
 }
 
 void ImageRenderer::end_render_pass() {
     vkCmdEndRenderPass(command_buffer_);
+}
+
+void ImageRenderer::end() {
     vk_assert(vkEndCommandBuffer(command_buffer_), "Failed to end the command buffer.");
 }
@@ -26,7 +26,13 @@ class ImageRenderer {
         , clear_values_{clear_values} {
     }
 
+    // resets and begins the command buffer so commands can be recorded before the render pass
+    VkCommandBuffer begin();
+
+    // sets the viewport and the scissor of the whole image since they are dynamic states of the pipelines
     VkCommandBuffer begin_render_pass();
 
     void end_render_pass();
+
+    void end();
 };
\ No newline at end of file
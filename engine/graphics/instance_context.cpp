@@ -1,10 +1,14 @@
 #include "instance_context.hpp"
 
+#include "graphics_error.hpp"
 #include "graphics_manager.hpp"
 #include "window_context.hpp"
 
 #include "utility/debug.hpp"
 
+#include <algorithm>
+#include <cstring>
+
 namespace {
 
     std::vector<char const *> get_glfw_extensions() {
@@ -13,10 +17,36 @@ namespace {
         return std::vector<char const *>(glfw_extensions, glfw_extensions + count);
     }
 
+    bool is_extension_supported(char const *name) {
+        uint32_t count;
+        vkEnumerateInstanceExtensionProperties(nullptr, &count, nullptr);
+        std::vector<VkExtensionProperties> extensions(count);
+        vkEnumerateInstanceExtensionProperties(nullptr, &count, extensions.data());
+        return std::any_of(extensions.begin(), extensions.end(), [name](VkExtensionProperties const &extension) {
+            return std::strcmp(extension.extensionName, name) == 0;
+        });
+    }
+
 } // namespace
 
 InstanceContext::InstanceContext(WindowConfig const &info) {
-    auto extensions = get_glfw_extensions();
+    std::vector<char const *> extensions;
+    bool headless_surface = false;
+    if (!info.headless) {
+        // the required extensions are unknown until glfw is initialized
+        WindowContext::init();
+        extensions = get_glfw_extensions();
+    } else if (info.headless_surface && is_extension_supported(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME)) {
+        extensions.push_back(VK_KHR_SURFACE_EXTENSION_NAME);
+        extensions.push_back(VK_EXT_HEADLESS_SURFACE_EXTENSION_NAME);
+        headless_surface = true;
+    }
+    if ((!info.headless || headless_surface) && is_extension_supported(VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME) &&
+        is_extension_supported(VK_EXT_SURFACE_MAINTENANCE_1_EXTENSION_NAME)) {
+        extensions.push_back(VK_KHR_GET_SURFACE_CAPABILITIES_2_EXTENSION_NAME);
+        extensions.push_back(VK_EXT_SURFACE_MAINTENANCE_1_EXTENSION_NAME);
+        surface_maintenance_ = true;
+    }
     std::vector<char const *> layers;
 #if defined DEBUG_APP
     extensions.push_back("VK_EXT_debug_utils");
@@ -26,6 +56,13 @@ InstanceContext::InstanceContext(WindowConfig const &info) {
 #if defined DEBUG_APP
     debug_messenger_ = GraphicsManager::make_debug_messenger(instance_);
 #endif
-    window_ = WindowContext::make_window(info);
-    surface_ = GraphicsManager::make_surface(instance_, window_.get());
+    if (!info.headless) {
+        window_ = WindowContext::make_window(info);
+        surface_ = GraphicsManager::make_surface(instance_, window_.get());
+    } else if (headless_surface) {
+        surface_ = GraphicsManager::make_headless_surface(instance_);
+        info_println("Render to headless surface");
+    } else {
+        info_println("Render to offscreen images");
+    }
 }
\ No newline at end of file
@@ -11,6 +11,7 @@ class InstanceContext {
     unique_ptr_of<VkDebugUtilsMessengerEXT> debug_messenger_;
     unique_ptr_of<GLFWwindow *> window_;
     unique_ptr_of<VkSurfaceKHR> surface_;
+    bool surface_maintenance_ = false;
 
   public:
     explicit InstanceContext(WindowConfig const &info);
@@ -19,6 +20,7 @@ class InstanceContext {
         return instance_.get();
     }
 
+    // surface is null when the headless rendering is performed offscreen
     VkSurfaceKHR get_surface() const {
         return surface_.get();
     }
@@ -26,4 +28,9 @@ class InstanceContext {
     GLFWwindow *get_window() const {
         return window_.get();
     }
+
+    // required by the swapchain maintenance extension of the device
+    bool is_surface_maintenance_enabled() const {
+        return surface_maintenance_;
+    }
 };
\ No newline at end of file
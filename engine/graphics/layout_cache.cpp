@@ -0,0 +1,75 @@
+#include "layout_cache.hpp"
+
+#include "graphics_manager.hpp"
+
+#include <algorithm>
+
+LayoutCache::LayoutCache(shared_ptr_of<VkDevice> device)
+    : device_{std::move(device)} {
+}
+
+shared_ptr_of<VkDescriptorSetLayout> LayoutCache::find_set_layout(std::span<VkDescriptorSetLayoutBinding const> bindings) {
+    key_t key;
+    key.reserve(bindings.size() * 2);
+    for (auto const &binding : bindings) {
+        key.push_back(uint64_t{binding.binding} << 32 | binding.descriptorCount);
+        key.push_back(uint64_t{static_cast<uint32_t>(binding.descriptorType)} << 32 | binding.stageFlags);
+    }
+    auto iter = set_layouts_.find(key);
+    if (iter != set_layouts_.end()) {
+        ++hits_;
+        return iter->second;
+    }
+    shared_ptr_of<VkDescriptorSetLayout> set_layout = GraphicsManager::make_descriptor_set_layout(device_, bindings);
+    set_layouts_.emplace(std::move(key), set_layout);
+    return set_layout;
+}
+
+shared_ptr_of<VkDescriptorSetLayout> LayoutCache::get_set_layout(std::span<VkDescriptorSetLayoutBinding const> bindings) {
+    std::lock_guard lock{mutex_};
+    return find_set_layout(bindings);
+}
+
+shared_ptr_of<VkPipelineLayout> LayoutCache::get_pipeline_layout(ShaderLayout const &layout,
+                                                                 std::initializer_list<ExternalSet> external_sets) {
+    std::lock_guard lock{mutex_};
+    std::vector<VkDescriptorSetLayout> set_layouts(layout.get_sets_count());
+    for (auto const &external : external_sets) {
+        set_layouts.resize(std::max<size_t>(set_layouts.size(), external.set + 1));
+        set_layouts[external.set] = external.set_layout;
+    }
+    key_t key;
+    for (uint32_t set = 0; set < set_layouts.size(); ++set) {
+        if (set_layouts[set] == nullptr) {
+            // the sets between the reflected and the external ones are empty
+            std::span<VkDescriptorSetLayoutBinding const> bindings;
+            if (set < layout.get_sets_count()) {
+                bindings = layout.get_set_bindings(set);
+            }
+            set_layouts[set] = find_set_layout(bindings).get();
+        }
+        key.push_back(reinterpret_cast<uint64_t>(set_layouts[set]));
+    }
+    for (auto const &range : layout.get_push_constant_ranges()) {
+        key.push_back(uint64_t{range.stageFlags} << 32 | range.offset);
+        key.push_back(range.size);
+    }
+    auto iter = pipeline_layouts_.find(key);
+    if (iter != pipeline_layouts_.end()) {
+        ++hits_;
+        return iter->second;
+    }
+    shared_ptr_of<VkPipelineLayout> pipeline_layout =
+        GraphicsManager::make_pipeline_layout(device_, set_layouts, layout.get_push_constant_ranges());
+    pipeline_layouts_.emplace(std::move(key), pipeline_layout);
+    return pipeline_layout;
+}
+
+LayoutCache::Statistics LayoutCache::get_statistics() const {
+    std::lock_guard lock{mutex_};
+    return Statistics{
+        .set_layouts_count = set_layouts_.size(),
+        .pipeline_layouts_count = pipeline_layouts_.size(),
+        .hits = hits_,
+    };
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include "shader_reflection.hpp"
+
+#include <initializer_list>
+#include <map>
+#include <mutex>
+#include <span>
+#include <vector>
+
+// shares the descriptor set layouts and the pipeline layouts between the pipelines with equal interfaces
+class LayoutCache {
+  public:
+    // set created outside of the cache which replaces the reflected one, e.g. the bindless table
+    struct ExternalSet {
+        uint32_t set;
+        VkDescriptorSetLayout set_layout;
+    };
+
+    struct Statistics {
+        size_t set_layouts_count = 0;
+        size_t pipeline_layouts_count = 0;
+        // requests satisfied with an existing layout
+        uint64_t hits = 0;
+    };
+
+  private:
+    using key_t = std::vector<uint64_t>;
+
+    shared_ptr_of<VkDevice> device_;
+    mutable std::mutex mutex_;
+    std::map<key_t, shared_ptr_of<VkDescriptorSetLayout>> set_layouts_;
+    // the pipeline layouts are keyed by the handles of the cached set layouts
+    std::map<key_t, shared_ptr_of<VkPipelineLayout>> pipeline_layouts_;
+    uint64_t hits_ = 0;
+
+    shared_ptr_of<VkDescriptorSetLayout> find_set_layout(std::span<VkDescriptorSetLayoutBinding const> bindings);
+
+  public:
+    explicit LayoutCache(shared_ptr_of<VkDevice> device);
+
+    // the bindings with immutable samplers are not supported, may be called from any thread
+    shared_ptr_of<VkDescriptorSetLayout> get_set_layout(std::span<VkDescriptorSetLayoutBinding const> bindings);
+
+    // every set of the layout gets the cached set layout, the unused sets are empty
+    shared_ptr_of<VkPipelineLayout> get_pipeline_layout(ShaderLayout const &layout, std::initializer_list<ExternalSet> external_sets = {});
+
+    Statistics get_statistics() const;
+};
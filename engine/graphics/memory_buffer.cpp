@@ -8,9 +8,10 @@ MemoryBuffer::MemoryBuffer(shared_ptr_of<VkDevice> device,
                            VkMemoryAllocateFlags flags,
                            VkDeviceSize size,
                            VkBufferUsageFlags usage,
-                           VkSharingMode mode)
+                           VkSharingMode mode,
+                           std::span<uint32_t const> qfm_indices)
     : device_{device.get()}
-    , buffer_{GraphicsManager::make_buffer(device, size, usage, mode)}
+    , buffer_{GraphicsManager::make_buffer(device, size, usage, mode, qfm_indices)}
     , allocator_{allocator} {
     VkMemoryRequirements requirements;
     vkGetBufferMemoryRequirements(device_, buffer_.get(), &requirements);
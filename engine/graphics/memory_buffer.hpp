@@ -2,6 +2,8 @@
 
 #include "allocator_interface.hpp"
 
+#include <span>
+
 class MemoryBuffer {
     VkDevice device_ = nullptr;
     unique_ptr_of<VkBuffer> buffer_;
@@ -15,7 +17,8 @@ class MemoryBuffer {
                  VkMemoryAllocateFlags flags,
                  VkDeviceSize size,
                  VkBufferUsageFlags usage,
-                 VkSharingMode mode = VK_SHARING_MODE_EXCLUSIVE);
+                 VkSharingMode mode = VK_SHARING_MODE_EXCLUSIVE,
+                 std::span<uint32_t const> qfm_indices = {});
 
     MemoryBuffer() = default;
     MemoryBuffer(MemoryBuffer &&) noexcept = default;
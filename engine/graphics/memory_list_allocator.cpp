@@ -3,6 +3,8 @@
 #include "graphics_error.hpp"
 #include "graphics_manager.hpp"
 
+#include "utility/trace.hpp"
+
 #include <algorithm>
 
 namespace {
@@ -18,6 +20,8 @@ MemoryBlock MemoryListAllocator::extend(uint32_t type_index, VkDeviceSize requir
     VkDeviceSize pool_size = std::max(std::min(memory_heap.size / size_divider, default_size), required_size);
     auto memory = GraphicsManager::make_device_memory(device_, pool_size, type_index);
     memory_to_type_[memory] = type_index;
+    ++statistics_.device_memory_count;
+    statistics_.device_memory_size += pool_size;
     return MemoryBlock(memory, 0, pool_size);
 }
 
@@ -52,6 +56,7 @@ MemoryListAllocator::MemoryListAllocator(shared_ptr_of<VkDevice> device, VkPhysi
 }
 
 MemoryBlock MemoryListAllocator::allocate(VkMemoryRequirements const &requirements, VkMemoryAllocateFlags flags) {
+    trace_zone("MemoryListAllocator::allocate");
     uint32_t type_index = memory_type_index(flags, requirements.memoryTypeBits);
     auto &memory_set = type_to_memory_[type_index];
     auto iter = std::ranges::find_if(memory_set, [&requirements](MemoryBlock const &block) {
@@ -65,12 +70,16 @@ MemoryBlock MemoryListAllocator::allocate(VkMemoryRequirements const &requiremen
             memory_set.insert(std::move(node));
         }
     } else {
+        trace_zone("MemoryListAllocator::extend");
         auto page = extend(type_index, requirements.size);
         block = extract(page, requirements);
         if (page.get_size() > 0) {
             memory_set.insert(page);
         }
     }
+    ++statistics_.allocations_count;
+    statistics_.used_size += block.get_size();
+    trace_counter("used_memory", statistics_.used_size);
     info_println("Allocate memory[{}]={}: size={}, alignment={}, offset={}.",
                  type_index,
                  reinterpret_cast<uintptr_t>(block.get_memory().get()),
@@ -88,6 +97,9 @@ void MemoryListAllocator::deallocate(MemoryBlock const &memblock) {
                  reinterpret_cast<uintptr_t>(memblock.get_memory().get()),
                  block.get_size(),
                  block.get_offset());
+    ++statistics_.deallocations_count;
+    statistics_.used_size -= block.get_size();
+    trace_counter("used_memory", statistics_.used_size);
     auto &memory_set = type_to_memory_[type_index];
     auto prev = memory_set.lower_bound(block);
     auto next = prev;
@@ -10,6 +10,7 @@ class MemoryListAllocator : public AllocatorInterface {
     VkPhysicalDeviceMemoryProperties memory_properties_;
     std::unordered_map<uint32_t, std::set<MemoryBlock>> type_to_memory_;
     std::unordered_map<shared_ptr_of<VkDeviceMemory>, uint32_t> memory_to_type_;
+    AllocatorStatistics statistics_;
 
     MemoryBlock extend(uint32_t type_index, VkDeviceSize required_size);
 
@@ -21,4 +22,8 @@ class MemoryListAllocator : public AllocatorInterface {
     MemoryBlock allocate(VkMemoryRequirements const &requirements, VkMemoryAllocateFlags flags) override;
 
     void deallocate(MemoryBlock const &block) override;
+
+    AllocatorStatistics get_statistics() const override {
+        return statistics_;
+    }
 };
\ No newline at end of file
@@ -0,0 +1,50 @@
+#include "offscreen_texture.hpp"
+
+#include "graphics_error.hpp"
+#include "graphics_manager.hpp"
+
+OffscreenTexture::OffscreenTexture(shared_ptr_of<VkDevice> device,
+                                   std::shared_ptr<AllocatorInterface> allocator,
+                                   VkFormat format,
+                                   VkImageUsageFlags usage,
+                                   VkExtent2D const &extent)
+    : device_{device}
+    , allocator_{allocator} {
+    VkImageCreateInfo info{
+        .sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO,
+        .imageType = VK_IMAGE_TYPE_2D,
+        .format = format,
+        .extent =
+            VkExtent3D{
+                .width = extent.width,
+                .height = extent.height,
+                .depth = 1,
+            },
+        .mipLevels = 1,
+        .arrayLayers = 1,
+        .samples = VK_SAMPLE_COUNT_1_BIT,
+        .tiling = VK_IMAGE_TILING_OPTIMAL,
+        .usage = usage,
+        .sharingMode = VK_SHARING_MODE_EXCLUSIVE,
+        .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
+    };
+    image_ = GraphicsManager::make_image(device_, info);
+    VkMemoryRequirements requirements;
+    vkGetImageMemoryRequirements(device_.get(), image_.get(), &requirements);
+    block_ = allocator_->allocate(requirements, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    VkDeviceMemory memory = block_.get_memory().get();
+    VkDeviceSize offset = block_.get_offset(requirements.alignment);
+    vk_assert(vkBindImageMemory(device_.get(), image_.get(), memory, offset),
+              "Failed to bind offscreen image={} to memory={} with offset={}.",
+              reinterpret_cast<uintptr_t>(image_.get()),
+              reinterpret_cast<uintptr_t>(memory),
+              offset);
+}
+
+OffscreenTexture::~OffscreenTexture() {
+    // the image is destroyed before its memory is returned to the allocator
+    image_.reset();
+    if (block_) {
+        allocator_->deallocate(block_);
+    }
+}
@@ -0,0 +1,24 @@
+#pragma once
+
+#include "allocator_interface.hpp"
+
+// color image owned by the engine which replaces a swapchain image when there is no surface
+class OffscreenTexture {
+    shared_ptr_of<VkDevice> device_;
+    std::shared_ptr<AllocatorInterface> allocator_;
+    MemoryBlock block_;
+    unique_ptr_of<VkImage> image_;
+
+  public:
+    OffscreenTexture(shared_ptr_of<VkDevice> device,
+                     std::shared_ptr<AllocatorInterface> allocator,
+                     VkFormat format,
+                     VkImageUsageFlags usage,
+                     VkExtent2D const &extent);
+
+    ~OffscreenTexture();
+
+    VkImage get_image() const {
+        return image_.get();
+    }
+};
@@ -1,7 +1,11 @@
 #include "pipeline_builder.hpp"
 
+#include "graphics/graphics_error.hpp"
 #include "graphics/graphics_manager.hpp"
 
+#include <algorithm>
+#include <iterator>
+
 namespace {
 
     VkPipelineInputAssemblyStateCreateInfo default_input_assembly_state() {
@@ -41,8 +45,9 @@ namespace {
 
 } // namespace
 
-PipelineBuilder::PipelineBuilder(shared_ptr_of<VkDevice> device)
+PipelineBuilder::PipelineBuilder(shared_ptr_of<VkDevice> device, VkPipelineCache pipeline_cache)
     : device_{device}
+    , pipeline_cache_{pipeline_cache}
     , input_assembly_state_(default_input_assembly_state())
     , rasterization_state_{default_rasterization_state()}
     , multisample_state_{default_multisample_state()}
@@ -58,9 +63,226 @@ PipelineBuilder::PipelineBuilder(shared_ptr_of<VkDevice> device)
           .basePipelineHandle = nullptr,
           .basePipelineIndex = -1,
       } {
+    viewport_state_.set_dynamic_counts(1, 1);
+    set_dynamic_states({VK_DYNAMIC_STATE_VIEWPORT, VK_DYNAMIC_STATE_SCISSOR});
+}
+
+PipelineBuilder::PipelineBuilder(PipelineBuilder const &other)
+    : device_{other.device_}
+    , pipeline_cache_{other.pipeline_cache_}
+    , shader_stages_{other.shader_stages_}
+    , shader_modules_{other.shader_modules_}
+    , shader_hashes_{other.shader_hashes_}
+    , entry_points_{other.entry_points_}
+    , specializations_{other.specializations_}
+    , module_identifiers_{other.module_identifiers_}
+    , vertex_input_state_{other.vertex_input_state_}
+    , input_assembly_state_{other.input_assembly_state_}
+    , tesselation_state_{other.tesselation_state_}
+    , viewport_state_{other.viewport_state_}
+    , rasterization_state_{other.rasterization_state_}
+    , multisample_state_{other.multisample_state_}
+    , depth_stencil_state_{other.depth_stencil_state_}
+    , color_blend_state_{other.color_blend_state_}
+    , dynamic_states_{other.dynamic_states_}
+    , dynamic_state_{other.dynamic_state_}
+    , pipeline_layout_{other.pipeline_layout_}
+    , pipeline_info_{other.pipeline_info_}
+    , render_pass_key_{other.render_pass_key_} {
+    update_pointers(other);
+}
+
+PipelineBuilder &PipelineBuilder::operator=(PipelineBuilder const &other) {
+    if (this != &other) {
+        device_ = other.device_;
+        pipeline_cache_ = other.pipeline_cache_;
+        shader_stages_ = other.shader_stages_;
+        shader_modules_ = other.shader_modules_;
+        shader_hashes_ = other.shader_hashes_;
+        entry_points_ = other.entry_points_;
+        specializations_ = other.specializations_;
+        module_identifiers_ = other.module_identifiers_;
+        vertex_input_state_ = other.vertex_input_state_;
+        input_assembly_state_ = other.input_assembly_state_;
+        tesselation_state_ = other.tesselation_state_;
+        viewport_state_ = other.viewport_state_;
+        rasterization_state_ = other.rasterization_state_;
+        multisample_state_ = other.multisample_state_;
+        depth_stencil_state_ = other.depth_stencil_state_;
+        color_blend_state_ = other.color_blend_state_;
+        dynamic_states_ = other.dynamic_states_;
+        dynamic_state_ = other.dynamic_state_;
+        pipeline_layout_ = other.pipeline_layout_;
+        pipeline_info_ = other.pipeline_info_;
+        render_pass_key_ = other.render_pass_key_;
+        update_pointers(other);
+    }
+    return *this;
+}
+
+void PipelineBuilder::update_pointers(PipelineBuilder const &other) {
+    pipeline_info_.pStages = shader_stages_.data();
+    update_shader_stages();
+    pipeline_info_.pVertexInputState = &vertex_input_state_.get();
+    pipeline_info_.pInputAssemblyState = &input_assembly_state_;
+    pipeline_info_.pTessellationState = tesselation_state_ ? &tesselation_state_.value() : nullptr;
+    pipeline_info_.pViewportState = &viewport_state_.get();
+    pipeline_info_.pRasterizationState = &rasterization_state_;
+    pipeline_info_.pMultisampleState = &multisample_state_;
+    pipeline_info_.pDepthStencilState = depth_stencil_state_ ? &depth_stencil_state_.value() : nullptr;
+    pipeline_info_.pColorBlendState = &color_blend_state_.get();
+    // dynamic states may be set by the info which points to the external array
+    if (dynamic_state_ && dynamic_state_->pDynamicStates == other.dynamic_states_.data()) {
+        dynamic_state_->pDynamicStates = dynamic_states_.data();
+    }
+    pipeline_info_.pDynamicState = dynamic_state_ ? &dynamic_state_.value() : nullptr;
+}
+
+void PipelineBuilder::update_shader_stages() {
+    // the stages set by the create infos point to the external data
+    if (entry_points_.size() != shader_stages_.size()) {
+        return;
+    }
+    for (size_t i = 0; i < shader_stages_.size(); ++i) {
+        shader_stages_[i].pName = entry_points_[i].c_str();
+        shader_stages_[i].pSpecializationInfo = specializations_[i].get_info();
+    }
+}
+
+void PipelineBuilder::set_specialization(VkShaderStageFlagBits stage, SpecializationConstants const &constants) {
+    for (size_t i = 0; i < specializations_.size(); ++i) {
+        if (shader_stages_[i].stage == stage) {
+            specializations_[i] = constants;
+            shader_stages_[i].pSpecializationInfo = specializations_[i].get_info();
+            return;
+        }
+    }
+    raise_error("There is no shader stage {} to specialize.", static_cast<uint32_t>(stage));
+}
+
+void PipelineBuilder::set_shader_layout(ShaderLayout const &layout,
+                                        LayoutCache &layout_cache,
+                                        std::initializer_list<LayoutCache::ExternalSet> external_sets) {
+    set_pipeline_layout(layout_cache.get_pipeline_layout(layout, external_sets));
+    VertexInputStateProvider vertex_input_state;
+    if (!layout.get_vertex_attributes().empty()) {
+        vertex_input_state.set_vertex_bindings({VkVertexInputBindingDescription{
+            .binding = 0,
+            .stride = layout.get_vertex_stride(),
+            .inputRate = VK_VERTEX_INPUT_RATE_VERTEX,
+        }});
+        vertex_input_state.set_vertex_attributes(std::vector(layout.get_vertex_attributes()));
+    }
+    set_vertex_input_state(std::move(vertex_input_state));
+}
+
+unique_ptr_of<VkPipeline> PipelineBuilder::make_from_identifiers(VkGraphicsPipelineCreateInfo info) const {
+    if (pipeline_cache_ == nullptr || info.stageCount == 0 || module_identifiers_.size() != shader_stages_.size()) {
+        return nullptr;
+    }
+    std::vector<VkPipelineShaderStageCreateInfo> stages(info.pStages, info.pStages + info.stageCount);
+    std::vector<VkPipelineShaderStageModuleIdentifierCreateInfoEXT> identifier_infos(stages.size());
+    for (size_t i = 0; i < stages.size(); ++i) {
+        auto iter = std::find_if(shader_stages_.begin(), shader_stages_.end(), [&stages, i](auto const &stage) {
+            return stage.stage == stages[i].stage;
+        });
+        if (iter == shader_stages_.end() || module_identifiers_[iter - shader_stages_.begin()].empty()) {
+            return nullptr;
+        }
+        auto const &identifier = module_identifiers_[iter - shader_stages_.begin()];
+        identifier_infos[i] = VkPipelineShaderStageModuleIdentifierCreateInfoEXT{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_MODULE_IDENTIFIER_CREATE_INFO_EXT,
+            .pNext = stages[i].pNext,
+            .identifierSize = static_cast<uint32_t>(identifier.size()),
+            .pIdentifier = identifier.data(),
+        };
+        stages[i].pNext = &identifier_infos[i];
+        stages[i].module = nullptr;
+    }
+    info.pStages = stages.data();
+    info.flags |= VK_PIPELINE_CREATE_FAIL_ON_PIPELINE_COMPILE_REQUIRED_BIT_EXT;
+    return GraphicsManager::make_cached_pipeline(device_, info, pipeline_cache_);
+}
+
+unique_ptr_of<VkPipeline> PipelineBuilder::make_pipeline() const {
+    // the pipeline compiled in the previous launches is created without the modules
+    if (auto pipeline = make_from_identifiers(pipeline_info_)) {
+        return pipeline;
+    }
+    return GraphicsManager::make_pipeline(device_, pipeline_info_, pipeline_cache_);
+}
+
+unique_ptr_of<VkPipeline> PipelineBuilder::make_library(VkGraphicsPipelineLibraryFlagBitsEXT part) const {
+    VkGraphicsPipelineLibraryCreateInfoEXT library_info{
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT,
+        .flags = static_cast<VkGraphicsPipelineLibraryFlagsEXT>(part),
+    };
+    // the libraries keep the intermediate representation so the linked pipeline can be optimized later
+    VkGraphicsPipelineCreateInfo info{
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .pNext = &library_info,
+        .flags = pipeline_info_.flags | VK_PIPELINE_CREATE_LIBRARY_BIT_KHR | VK_PIPELINE_CREATE_RETAIN_LINK_TIME_OPTIMIZATION_INFO_BIT_EXT,
+        .pDynamicState = pipeline_info_.pDynamicState,
+        .basePipelineHandle = nullptr,
+        .basePipelineIndex = -1,
+    };
+    if (part != VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT) {
+        info.renderPass = pipeline_info_.renderPass;
+        info.subpass = pipeline_info_.subpass;
+    }
+    std::vector<VkPipelineShaderStageCreateInfo> stages;
+    switch (part) {
+        case VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT:
+            info.pVertexInputState = pipeline_info_.pVertexInputState;
+            info.pInputAssemblyState = pipeline_info_.pInputAssemblyState;
+            break;
+        case VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT:
+            std::copy_if(shader_stages_.begin(), shader_stages_.end(), std::back_inserter(stages), [](auto const &stage) {
+                return stage.stage != VK_SHADER_STAGE_FRAGMENT_BIT;
+            });
+            info.pTessellationState = pipeline_info_.pTessellationState;
+            info.pViewportState = pipeline_info_.pViewportState;
+            info.pRasterizationState = pipeline_info_.pRasterizationState;
+            info.layout = pipeline_info_.layout;
+            break;
+        case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT:
+            std::copy_if(shader_stages_.begin(), shader_stages_.end(), std::back_inserter(stages), [](auto const &stage) {
+                return stage.stage == VK_SHADER_STAGE_FRAGMENT_BIT;
+            });
+            info.pMultisampleState = pipeline_info_.pMultisampleState;
+            info.pDepthStencilState = pipeline_info_.pDepthStencilState;
+            info.layout = pipeline_info_.layout;
+            break;
+        case VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT:
+            info.pMultisampleState = pipeline_info_.pMultisampleState;
+            info.pColorBlendState = pipeline_info_.pColorBlendState;
+            break;
+        default:
+            raise_error("Unexpected pipeline library part {}.", static_cast<uint32_t>(part));
+    }
+    info.stageCount = static_cast<uint32_t>(stages.size());
+    info.pStages = stages.data();
+    if (auto library = make_from_identifiers(info)) {
+        return library;
+    }
+    return GraphicsManager::make_pipeline(device_, info, pipeline_cache_);
 }
 
-unique_ptr_of<VkPipeline> PipelineBuilder::make_pipeline() {
-    return GraphicsManager::make_pipeline(device_, pipeline_info_);
+unique_ptr_of<VkPipeline> PipelineBuilder::link_libraries(std::span<VkPipeline const> libraries, bool optimize) const {
+    VkPipelineLibraryCreateInfoKHR library_info{
+        .sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR,
+        .libraryCount = static_cast<uint32_t>(libraries.size()),
+        .pLibraries = libraries.data(),
+    };
+    // all the state comes from the libraries
+    VkGraphicsPipelineCreateInfo info{
+        .sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO,
+        .pNext = &library_info,
+        .flags = optimize ? VK_PIPELINE_CREATE_LINK_TIME_OPTIMIZATION_BIT_EXT : 0,
+        .layout = pipeline_info_.layout,
+        .basePipelineHandle = nullptr,
+        .basePipelineIndex = -1,
+    };
+    return GraphicsManager::make_pipeline(device_, info, pipeline_cache_);
 }
 
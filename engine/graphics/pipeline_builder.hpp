@@ -1,8 +1,13 @@
 #pragma once
 
 #include "graphics/graphics_types.hpp"
+#include "graphics/layout_cache.hpp"
+#include "graphics/shader_context.hpp"
 
+#include <initializer_list>
 #include <optional>
+#include <span>
+#include <string>
 
 class VertexInputStateProvider {
     VkPipelineVertexInputStateCreateInfo vertex_input_state_{
@@ -12,6 +17,26 @@ class VertexInputStateProvider {
     std::vector<VkVertexInputAttributeDescription> vertex_attributes_;
 
   public:
+    VertexInputStateProvider() = default;
+
+    // the state points to the own arrays of the copy
+    VertexInputStateProvider(VertexInputStateProvider const &other)
+        : vertex_input_state_{other.vertex_input_state_}
+        , vertex_bindings_{other.vertex_bindings_}
+        , vertex_attributes_{other.vertex_attributes_} {
+        vertex_input_state_.pVertexBindingDescriptions = vertex_bindings_.data();
+        vertex_input_state_.pVertexAttributeDescriptions = vertex_attributes_.data();
+    }
+
+    VertexInputStateProvider &operator=(VertexInputStateProvider const &other) {
+        vertex_input_state_ = other.vertex_input_state_;
+        vertex_bindings_ = other.vertex_bindings_;
+        vertex_attributes_ = other.vertex_attributes_;
+        vertex_input_state_.pVertexBindingDescriptions = vertex_bindings_.data();
+        vertex_input_state_.pVertexAttributeDescriptions = vertex_attributes_.data();
+        return *this;
+    }
+
     VkPipelineVertexInputStateCreateInfo const &get() const {
         return vertex_input_state_;
     }
@@ -36,7 +61,30 @@ class ViewportStateProvider {
     std::vector<VkViewport> viewports_;
     std::vector<VkRect2D> scissors_;
 
+    // dynamic viewports and scissors have no arrays
+    void update_pointers() {
+        viewport_state_.pViewports = viewports_.empty() ? nullptr : viewports_.data();
+        viewport_state_.pScissors = scissors_.empty() ? nullptr : scissors_.data();
+    }
+
   public:
+    ViewportStateProvider() = default;
+
+    ViewportStateProvider(ViewportStateProvider const &other)
+        : viewport_state_{other.viewport_state_}
+        , viewports_{other.viewports_}
+        , scissors_{other.scissors_} {
+        update_pointers();
+    }
+
+    ViewportStateProvider &operator=(ViewportStateProvider const &other) {
+        viewport_state_ = other.viewport_state_;
+        viewports_ = other.viewports_;
+        scissors_ = other.scissors_;
+        update_pointers();
+        return *this;
+    }
+
     VkPipelineViewportStateCreateInfo const &get() const {
         return viewport_state_;
     }
@@ -52,6 +100,16 @@ class ViewportStateProvider {
         viewport_state_.scissorCount = static_cast<uint32_t>(scissors_.size());
         viewport_state_.pScissors = scissors_.data();
     }
+
+    // viewports and scissors are set by the command buffer when they are dynamic so only their count is required
+    void set_dynamic_counts(uint32_t viewports_count, uint32_t scissors_count) {
+        viewports_.clear();
+        scissors_.clear();
+        viewport_state_.viewportCount = viewports_count;
+        viewport_state_.pViewports = nullptr;
+        viewport_state_.scissorCount = scissors_count;
+        viewport_state_.pScissors = nullptr;
+    }
 };
 
 class ColorBlendStateProvider {
@@ -83,6 +141,19 @@ class ColorBlendStateProvider {
         : ColorBlendStateProvider(VK_FALSE, VK_LOGIC_OP_COPY) {
     }
 
+    ColorBlendStateProvider(ColorBlendStateProvider const &other)
+        : attachments_{other.attachments_}
+        , color_blend_state_{other.color_blend_state_} {
+        color_blend_state_.pAttachments = attachments_.data();
+    }
+
+    ColorBlendStateProvider &operator=(ColorBlendStateProvider const &other) {
+        attachments_ = other.attachments_;
+        color_blend_state_ = other.color_blend_state_;
+        color_blend_state_.pAttachments = attachments_.data();
+        return *this;
+    }
+
     VkPipelineColorBlendStateCreateInfo const &get() const {
         return color_blend_state_;
     }
@@ -95,8 +166,25 @@ class ColorBlendStateProvider {
 };
 
 class PipelineBuilder {
+  public:
+    // the parts of VK_EXT_graphics_pipeline_library which make a complete pipeline
+    static constexpr VkGraphicsPipelineLibraryFlagsEXT all_library_parts =
+        VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT | VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT |
+        VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT | VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+
+  private:
     shared_ptr_of<VkDevice> device_;
+    VkPipelineCache pipeline_cache_;
     std::vector<VkPipelineShaderStageCreateInfo> shader_stages_;
+    // modules of the stages set by the shaders, the snapshots compiled on other threads keep them alive over the reloads
+    std::vector<shared_ptr_of<VkShaderModule>> shader_modules_;
+    // hashes of the shader code which identify the stages in the pipeline description
+    std::vector<uint64_t> shader_hashes_;
+    // the stages set by the shaders point to their entry points and constants kept here
+    std::vector<std::string> entry_points_;
+    std::vector<SpecializationConstants> specializations_;
+    // identifiers of the stage modules, the pipelines are created from the cache by them when all stages have one
+    std::vector<std::vector<uint8_t>> module_identifiers_;
     VertexInputStateProvider vertex_input_state_;
     VkPipelineInputAssemblyStateCreateInfo input_assembly_state_;
     std::optional<VkPipelineTessellationStateCreateInfo> tesselation_state_;
@@ -105,21 +193,91 @@ class PipelineBuilder {
     VkPipelineMultisampleStateCreateInfo multisample_state_;
     std::optional<VkPipelineDepthStencilStateCreateInfo> depth_stencil_state_;
     ColorBlendStateProvider color_blend_state_;
+    std::vector<VkDynamicState> dynamic_states_;
     std::optional<VkPipelineDynamicStateCreateInfo> dynamic_state_;
     shared_ptr_of<VkPipelineLayout> pipeline_layout_;
     VkGraphicsPipelineCreateInfo pipeline_info_;
+    uint64_t render_pass_key_ = 0;
+
+    // the create info points to the states of this builder, not of the one it was copied from
+    void update_pointers(PipelineBuilder const &other);
+
+    void update_shader_stages();
+
+    // returns null if a stage has no identifier or the pipeline is not in the cache
+    unique_ptr_of<VkPipeline> make_from_identifiers(VkGraphicsPipelineCreateInfo info) const;
 
   public:
-    explicit PipelineBuilder(shared_ptr_of<VkDevice> device);
+    PipelineBuilder(shared_ptr_of<VkDevice> device, VkPipelineCache pipeline_cache);
+
+    // the copy is a snapshot of the state which can be compiled on another thread
+    PipelineBuilder(PipelineBuilder const &other);
 
-    unique_ptr_of<VkPipeline> make_pipeline();
+    PipelineBuilder &operator=(PipelineBuilder const &other);
 
+    unique_ptr_of<VkPipeline> make_pipeline() const;
+
+    // compiles only the state of the part so the parts can be shared by the pipelines which differ in the other ones
+    unique_ptr_of<VkPipeline> make_library(VkGraphicsPipelineLibraryFlagBitsEXT part) const;
+
+    // fast linking skips the link time optimization so the pipeline is ready sooner but may run slower
+    unique_ptr_of<VkPipeline> link_libraries(std::span<VkPipeline const> libraries, bool optimize) const;
+
+    VkGraphicsPipelineCreateInfo const &get_pipeline_info() const {
+        return pipeline_info_;
+    }
+
+    std::vector<uint64_t> const &get_shader_hashes() const {
+        return shader_hashes_;
+    }
+
+    uint64_t get_render_pass_key() const {
+        return render_pass_key_;
+    }
+
+    shared_ptr_of<VkPipelineLayout> const &get_pipeline_layout() const {
+        return pipeline_layout_;
+    }
+
+    // the modules, the names and the specialization infos of the stages have to outlive the builder and its copies
     void set_shader_stages(std::vector<VkPipelineShaderStageCreateInfo> &&shader_stages) {
         shader_stages_ = std::move(shader_stages);
+        shader_modules_.clear();
+        shader_hashes_.clear();
+        module_identifiers_.clear();
+        entry_points_.clear();
+        specializations_.clear();
         pipeline_info_.stageCount = static_cast<uint32_t>(shader_stages_.size());
         pipeline_info_.pStages = shader_stages_.data();
     }
 
+    void set_shader_stages(std::initializer_list<ShaderContext const *> shaders) {
+        std::vector<VkPipelineShaderStageCreateInfo> shader_stages;
+        std::vector<shared_ptr_of<VkShaderModule>> shader_modules;
+        std::vector<uint64_t> shader_hashes;
+        std::vector<std::vector<uint8_t>> module_identifiers;
+        std::vector<std::string> entry_points;
+        std::vector<SpecializationConstants> specializations;
+        for (auto shader : shaders) {
+            shader_stages.push_back(shader->get_shader_stage());
+            shader_modules.push_back(shader->get_shader_module());
+            shader_hashes.push_back(shader->get_code_hash());
+            module_identifiers.push_back(shader->get_module_identifier());
+            entry_points.push_back(shader->get_entry_point());
+            specializations.push_back(shader->get_specialization());
+        }
+        set_shader_stages(std::move(shader_stages));
+        shader_modules_ = std::move(shader_modules);
+        shader_hashes_ = std::move(shader_hashes);
+        module_identifiers_ = std::move(module_identifiers);
+        entry_points_ = std::move(entry_points);
+        specializations_ = std::move(specializations);
+        update_shader_stages();
+    }
+
+    // replaces the constants of the stage set by the shader, the permutations are compiled as separate pipelines
+    void set_specialization(VkShaderStageFlagBits stage, SpecializationConstants const &constants);
+
     void set_vertex_input_state(VertexInputStateProvider &&provider) {
         vertex_input_state_ = std::move(provider);
         pipeline_info_.pVertexInputState = &vertex_input_state_.get();
@@ -162,12 +320,29 @@ class PipelineBuilder {
         pipeline_info_.pDynamicState = &dynamic_state_.value();
     }
 
+    // viewport and scissor are dynamic by default so the pipeline does not depend on the surface extent
+    void set_dynamic_states(std::vector<VkDynamicState> &&dynamic_states) {
+        dynamic_states_.swap(dynamic_states);
+        set_dynamic_state(VkPipelineDynamicStateCreateInfo{
+            .sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO,
+            .dynamicStateCount = static_cast<uint32_t>(dynamic_states_.size()),
+            .pDynamicStates = dynamic_states_.data(),
+        });
+    }
+
     void set_pipeline_layout(shared_ptr_of<VkPipelineLayout> pipeline_layout) {
         pipeline_layout_.swap(pipeline_layout);
         pipeline_info_.layout = pipeline_layout_.get();
     }
 
-    void set_render_pass(VkRenderPass render_pass) {
+    // the pipeline layout is shared through the cache, the vertex attributes are read from the buffer of binding 0
+    void set_shader_layout(ShaderLayout const &layout,
+                           LayoutCache &layout_cache,
+                           std::initializer_list<LayoutCache::ExternalSet> external_sets = {});
+
+    // pipelines of the builders with equal keys are shared by the compatible render passes
+    void set_render_pass(VkRenderPass render_pass, uint64_t compatibility_key = 0) {
         pipeline_info_.renderPass = render_pass;
+        render_pass_key_ = compatibility_key;
     }
 };
\ No newline at end of file
@@ -0,0 +1,92 @@
+#include "pipeline_cache.hpp"
+
+#include "graphics_error.hpp"
+#include "graphics_manager.hpp"
+
+#include <cstring>
+#include <exception>
+#include <fstream>
+#include <vector>
+
+namespace {
+
+    std::vector<std::byte> read_file(std::filesystem::path const &path) {
+        std::ifstream fin{path, std::ios::binary | std::ios::ate};
+        if (!fin.is_open()) {
+            return {};
+        }
+        std::vector<std::byte> data(static_cast<size_t>(fin.tellg()));
+        fin.seekg(0);
+        if (!fin.read(reinterpret_cast<char *>(data.data()), data.size())) {
+            return {};
+        }
+        return data;
+    }
+
+    // the data of another device or driver is rejected by the header before it reaches the driver
+    bool is_compatible(std::vector<std::byte> const &data, VkPhysicalDeviceProperties const &properties) {
+        VkPipelineCacheHeaderVersionOne header;
+        if (data.size() < sizeof(header)) {
+            return false;
+        }
+        std::memcpy(&header, data.data(), sizeof(header));
+        return header.headerSize >= sizeof(header) && header.headerSize <= data.size() &&
+               header.headerVersion == VK_PIPELINE_CACHE_HEADER_VERSION_ONE && header.vendorID == properties.vendorID &&
+               header.deviceID == properties.deviceID &&
+               std::memcmp(header.pipelineCacheUUID, properties.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+    }
+
+} // namespace
+
+PipelineCache::PipelineCache(shared_ptr_of<VkDevice> device, VkPhysicalDeviceProperties const &properties, std::filesystem::path path)
+    : device_{device}
+    , path_{std::move(path)} {
+    std::vector<std::byte> data;
+    if (!path_.empty()) {
+        data = read_file(path_);
+        if (!data.empty() && !is_compatible(data, properties)) {
+            info_println("Pipeline cache {} is not compatible with the device", path_.string());
+            data.clear();
+        }
+    }
+    info_println("Load pipeline cache: size={}", data.size());
+    pipeline_cache_ = GraphicsManager::make_pipeline_cache(device, data);
+    saved_size_ = data.size();
+}
+
+PipelineCache::~PipelineCache() {
+    try {
+        save();
+    } catch (std::exception const &ex) {
+        error_println("{}", ex.what());
+    }
+}
+
+void PipelineCache::save() {
+    if (path_.empty()) {
+        return;
+    }
+    size_t size = 0;
+    vk_assert(vkGetPipelineCacheData(device_.get(), pipeline_cache_.get(), &size, nullptr), "Failed to get pipeline cache size.");
+    if (size == saved_size_) {
+        return;
+    }
+    std::vector<std::byte> data(size);
+    VkResult result = vkGetPipelineCacheData(device_.get(), pipeline_cache_.get(), &size, data.data());
+    // the data may be truncated if the cache has grown since the size was queried
+    if (result != VK_INCOMPLETE) {
+        vk_assert(result, "Failed to get pipeline cache data.");
+    }
+    data.resize(size);
+    auto temp_path = path_;
+    temp_path += ".tmp";
+    {
+        std::ofstream fout{temp_path, std::ios::binary | std::ios::trunc};
+        if (!fout.write(reinterpret_cast<char const *>(data.data()), data.size()) || !fout.flush()) {
+            raise_error("Failed to write pipeline cache {}.", temp_path.string());
+        }
+    }
+    std::filesystem::rename(temp_path, path_);
+    saved_size_ = size;
+    info_println("Save pipeline cache: size={}", size);
+}
@@ -0,0 +1,30 @@
+#pragma once
+
+#include "graphics_types.hpp"
+
+#include <filesystem>
+
+// pipeline cache which is loaded from the file and saved back so the pipelines are not compiled from scratch every launch
+class PipelineCache {
+    shared_ptr_of<VkDevice> device_;
+    std::filesystem::path path_;
+    unique_ptr_of<VkPipelineCache> pipeline_cache_;
+    // size of the data in the file, the cache is not saved while it has not grown
+    size_t saved_size_ = 0;
+
+  public:
+    // empty path disables loading and saving
+    PipelineCache(shared_ptr_of<VkDevice> device, VkPhysicalDeviceProperties const &properties, std::filesystem::path path);
+
+    PipelineCache(PipelineCache const &) = delete;
+    PipelineCache &operator=(PipelineCache const &) = delete;
+
+    ~PipelineCache();
+
+    VkPipelineCache get_pipeline_cache() const {
+        return pipeline_cache_.get();
+    }
+
+    // the data is written to a temporary file which replaces the previous one so the file is never left partially written
+    void save();
+};
@@ -0,0 +1,135 @@
+#include "pipeline_compiler.hpp"
+
+#include "utility/log.hpp"
+#include "utility/trace.hpp"
+
+#include <algorithm>
+#include <exception>
+
+PipelineCompiler::PipelineCompiler(uint32_t threads_count, PipelineRegistry *registry)
+    : registry_{registry} {
+    if (threads_count == 0) {
+        threads_count = std::max(std::thread::hardware_concurrency(), 2u) - 1;
+    }
+    info_println("Use {} pipeline compiler threads", threads_count);
+    workers_.reserve(threads_count);
+    for (uint32_t i = 0; i < threads_count; ++i) {
+        workers_.emplace_back(&PipelineCompiler::run_worker, this);
+    }
+}
+
+PipelineCompiler::~PipelineCompiler() {
+    {
+        std::lock_guard lock{mutex_};
+        stopping_ = true;
+        tasks_.clear();
+        optimize_tasks_.clear();
+    }
+    condition_.notify_all();
+    for (auto &worker : workers_) {
+        worker.join();
+    }
+}
+
+PipelineCompiler::Handle PipelineCompiler::compile(PipelineBuilder const &builder) {
+    Task task{.builder = builder, .optimized = std::make_shared<OptimizedPipeline>()};
+    Handle handle{task.promise.get_future().share(), task.optimized};
+    {
+        std::lock_guard lock{mutex_};
+        tasks_.push_back(std::move(task));
+    }
+    condition_.notify_one();
+    return handle;
+}
+
+void PipelineCompiler::set_ready_callback(ready_t const &callback) {
+    std::lock_guard lock{mutex_};
+    ready_callback_ = callback;
+}
+
+size_t PipelineCompiler::get_pending_count() const {
+    std::lock_guard lock{mutex_};
+    return tasks_.size() + compiling_count_;
+}
+
+size_t PipelineCompiler::get_optimizing_count() const {
+    std::lock_guard lock{mutex_};
+    return optimize_tasks_.size() + optimizing_count_;
+}
+
+void PipelineCompiler::run_worker() {
+    trace_thread_name("pipeline compiler");
+    std::unique_lock lock{mutex_};
+    while (true) {
+        condition_.wait(lock, [this] { return stopping_ || !tasks_.empty() || !optimize_tasks_.empty(); });
+        if (stopping_) {
+            return;
+        }
+        if (!tasks_.empty()) {
+            Task task = std::move(tasks_.front());
+            tasks_.pop_front();
+            compile_task(task, lock);
+        } else {
+            Task task = std::move(optimize_tasks_.front());
+            optimize_tasks_.pop_front();
+            optimize_task(task, lock);
+        }
+        if (ready_callback_) {
+            auto callback = ready_callback_;
+            lock.unlock();
+            callback();
+            lock.lock();
+        }
+    }
+}
+
+void PipelineCompiler::compile_task(Task &task, std::unique_lock<std::mutex> &lock) {
+    ++compiling_count_;
+    lock.unlock();
+    PipelineRegistry::LinkResult result{.optimized = true};
+    std::exception_ptr error;
+    {
+        trace_zone("compile_pipeline");
+        // pipeline creation is thread safe with the shared pipeline cache
+        try {
+            if (registry_) {
+                result = registry_->link_pipeline(task.builder);
+            } else {
+                result.pipeline = task.builder.make_pipeline();
+            }
+        } catch (...) {
+            error = std::current_exception();
+        }
+    }
+    lock.lock();
+    // the pending count does not include the pipeline once its handle is ready
+    --compiling_count_;
+    if (error) {
+        task.promise.set_exception(error);
+        return;
+    }
+    task.promise.set_value(std::move(result.pipeline));
+    if (!result.optimized) {
+        // the fast linked pipeline is in use while the optimized one is linked
+        optimize_tasks_.push_back(std::move(task));
+        condition_.notify_one();
+    }
+}
+
+void PipelineCompiler::optimize_task(Task &task, std::unique_lock<std::mutex> &lock) {
+    ++optimizing_count_;
+    lock.unlock();
+    shared_ptr_of<VkPipeline> pipeline;
+    {
+        trace_zone("optimize_pipeline");
+        try {
+            pipeline = registry_->optimize_pipeline(task.builder);
+        } catch (std::exception const &ex) {
+            // the fast linked pipeline stays in use
+            error_println("Failed to optimize the pipeline: {}", ex.what());
+        }
+    }
+    task.optimized->set(std::move(pipeline));
+    lock.lock();
+    --optimizing_count_;
+}
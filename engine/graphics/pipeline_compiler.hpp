@@ -0,0 +1,125 @@
+#pragma once
+
+#include "pipeline_builder.hpp"
+#include "pipeline_registry.hpp"
+
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+// compiles pipelines by the worker threads so the calling thread is never blocked by the shader compilation
+class PipelineCompiler {
+  public:
+    // pipeline linked with the link time optimization in the background after the fast linked one
+    class OptimizedPipeline {
+        mutable std::mutex mutex_;
+        shared_ptr_of<VkPipeline> pipeline_;
+
+      public:
+        VkPipeline get() const {
+            std::lock_guard lock{mutex_};
+            return pipeline_.get();
+        }
+
+        void set(shared_ptr_of<VkPipeline> pipeline) {
+            std::lock_guard lock{mutex_};
+            pipeline_ = std::move(pipeline);
+        }
+    };
+
+    // pipeline which is null until it has been compiled
+    class Handle {
+        std::shared_future<shared_ptr_of<VkPipeline>> future_;
+        // the fast linked pipeline is kept alive by the future so it can be in use after the replacement
+        std::shared_ptr<OptimizedPipeline> optimized_;
+
+      public:
+        Handle() = default;
+
+        Handle(std::shared_future<shared_ptr_of<VkPipeline>> future, std::shared_ptr<OptimizedPipeline> optimized)
+            : future_{std::move(future)}
+            , optimized_{std::move(optimized)} {
+        }
+
+        bool is_valid() const {
+            return future_.valid();
+        }
+
+        bool is_ready() const {
+            return future_.valid() && future_.wait_for(std::chrono::seconds{0}) == std::future_status::ready;
+        }
+
+        // true once the fast linked pipeline has been replaced by the optimized one
+        bool is_optimized() const {
+            return optimized_ && optimized_->get() != nullptr;
+        }
+
+        // returns null while the pipeline is compiled, rethrows the compilation error,
+        // the returned pipeline may change once so the commands have to be recorded again on the ready callback
+        VkPipeline get() const {
+            if (is_optimized()) {
+                return optimized_->get();
+            }
+            return is_ready() ? future_.get().get() : nullptr;
+        }
+
+        // blocks until the pipeline is compiled
+        VkPipeline wait() const {
+            VkPipeline pipeline = future_.get().get();
+            return is_optimized() ? optimized_->get() : pipeline;
+        }
+    };
+
+    using ready_t = std::function<void()>;
+
+  private:
+    struct Task {
+        PipelineBuilder builder;
+        std::promise<shared_ptr_of<VkPipeline>> promise;
+        std::shared_ptr<OptimizedPipeline> optimized;
+    };
+
+    mutable std::mutex mutex_;
+    std::condition_variable condition_;
+    std::deque<Task> tasks_;
+    // the optimization is done only when there are no pipelines to compile
+    std::deque<Task> optimize_tasks_;
+    size_t compiling_count_ = 0;
+    size_t optimizing_count_ = 0;
+    bool stopping_ = false;
+    ready_t ready_callback_;
+    PipelineRegistry *registry_;
+    std::vector<std::thread> workers_;
+
+    void run_worker();
+
+    void compile_task(Task &task, std::unique_lock<std::mutex> &lock);
+
+    void optimize_task(Task &task, std::unique_lock<std::mutex> &lock);
+
+  public:
+    // zero threads count means the number of the hardware threads except the calling one,
+    // equal pipelines are shared through the registry if it's not null
+    explicit PipelineCompiler(uint32_t threads_count = 0, PipelineRegistry *registry = nullptr);
+
+    PipelineCompiler(PipelineCompiler const &) = delete;
+    PipelineCompiler &operator=(PipelineCompiler const &) = delete;
+
+    // the queued pipelines are not compiled, their handles report the broken promise
+    ~PipelineCompiler();
+
+    // the builder state is copied so the builder may be changed right after the call
+    Handle compile(PipelineBuilder const &builder);
+
+    // called by a worker thread after every compiled or optimized pipeline
+    void set_ready_callback(ready_t const &callback);
+
+    // pipelines which handles are not ready yet
+    size_t get_pending_count() const;
+
+    size_t get_optimizing_count() const;
+};
@@ -0,0 +1,273 @@
+#include "pipeline_description.hpp"
+
+#include "pipeline_builder.hpp"
+
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <string_view>
+#include <type_traits>
+
+namespace {
+
+    constexpr inline uint64_t fnv_offset = 14695981039346656037ull;
+    constexpr inline uint64_t fnv_prime = 1099511628211ull;
+
+    // fields are written one by one since the structures have padding and pointers
+    class DescriptionWriter {
+        std::vector<uint64_t> &words_;
+
+      public:
+        explicit DescriptionWriter(std::vector<uint64_t> &words)
+            : words_{words} {
+        }
+
+        template <typename T>
+            requires std::is_integral_v<T> || std::is_enum_v<T>
+        void write(T value) {
+            words_.push_back(static_cast<uint64_t>(value));
+        }
+
+        void write(float value) {
+            words_.push_back(std::bit_cast<uint32_t>(value));
+        }
+
+        void write(std::string_view str) {
+            write(PipelineDescription::hash_bytes(std::as_bytes(std::span(str))));
+        }
+
+        // the data is kept as is so the descriptions with different values are never equal
+        void write_data(void const *data, size_t size) {
+            write(size);
+            auto bytes = static_cast<std::byte const *>(data);
+            for (size_t offset = 0; offset < size; offset += sizeof(uint64_t)) {
+                uint64_t word = 0;
+                std::memcpy(&word, bytes + offset, std::min(sizeof(uint64_t), size - offset));
+                write(word);
+            }
+        }
+
+        template <typename T, typename F>
+        void write_array(T const *data, uint32_t count, F const &write_elem) {
+            write(count);
+            for (uint32_t i = 0; data != nullptr && i < count; ++i) {
+                write_elem(data[i]);
+            }
+        }
+    };
+
+    void write_stencil_state(DescriptionWriter &writer, VkStencilOpState const &state) {
+        writer.write(state.failOp);
+        writer.write(state.passOp);
+        writer.write(state.depthFailOp);
+        writer.write(state.compareOp);
+        writer.write(state.compareMask);
+        writer.write(state.writeMask);
+        writer.write(state.reference);
+    }
+
+    void write_attachment_reference(DescriptionWriter &writer, VkAttachmentReference const &reference) {
+        // layouts do not affect the compatibility
+        writer.write(reference.attachment);
+    }
+
+} // namespace
+
+uint64_t PipelineDescription::hash_bytes(std::span<std::byte const> bytes, uint64_t seed) {
+    uint64_t hash = fnv_offset ^ seed;
+    for (std::byte byte : bytes) {
+        hash = (hash ^ static_cast<uint64_t>(byte)) * fnv_prime;
+    }
+    return hash;
+}
+
+PipelineDescription::PipelineDescription(PipelineBuilder const &builder)
+    : PipelineDescription(builder, PipelineBuilder::all_library_parts) {
+}
+
+PipelineDescription::PipelineDescription(PipelineBuilder const &builder, VkGraphicsPipelineLibraryFlagsEXT parts) {
+    VkGraphicsPipelineCreateInfo const &info = builder.get_pipeline_info();
+    DescriptionWriter writer{words_};
+    writer.write(info.flags);
+    writer.write(parts);
+    bool const vertex_input = parts & VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT;
+    bool const pre_rasterization = parts & VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT;
+    bool const fragment_shader = parts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+    bool const fragment_output = parts & VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+
+    auto const &shader_hashes = builder.get_shader_hashes();
+    for (uint32_t i = 0; i < info.stageCount; ++i) {
+        auto const &stage = info.pStages[i];
+        // the fragment stage belongs to its own part and the other stages to the pre-rasterization one
+        if (!(stage.stage == VK_SHADER_STAGE_FRAGMENT_BIT ? fragment_shader : pre_rasterization)) {
+            continue;
+        }
+        writer.write(stage.stage);
+        // the module handle is the fallback for the stages which have been set without the shader code hash
+        writer.write(i < shader_hashes.size() ? shader_hashes[i] : reinterpret_cast<uint64_t>(stage.module));
+        writer.write(std::string_view{stage.pName});
+        if (auto specialization = stage.pSpecializationInfo) {
+            writer.write_array(specialization->pMapEntries, specialization->mapEntryCount, [&writer](auto const &entry) {
+                writer.write(entry.constantID);
+                writer.write(entry.offset);
+                writer.write(entry.size);
+            });
+            // every permutation of the constants is a separate pipeline
+            writer.write_data(specialization->pData, specialization->dataSize);
+        } else {
+            writer.write(uint64_t{0});
+        }
+    }
+
+    if (vertex_input) {
+        auto const &vertex_input_state = *info.pVertexInputState;
+        writer.write_array(vertex_input_state.pVertexBindingDescriptions,
+                           vertex_input_state.vertexBindingDescriptionCount,
+                           [&writer](auto const &binding) {
+                               writer.write(binding.binding);
+                               writer.write(binding.stride);
+                               writer.write(binding.inputRate);
+                           });
+        writer.write_array(vertex_input_state.pVertexAttributeDescriptions,
+                           vertex_input_state.vertexAttributeDescriptionCount,
+                           [&writer](auto const &attribute) {
+                               writer.write(attribute.location);
+                               writer.write(attribute.binding);
+                               writer.write(attribute.format);
+                               writer.write(attribute.offset);
+                           });
+
+        writer.write(info.pInputAssemblyState->topology);
+        writer.write(info.pInputAssemblyState->primitiveRestartEnable);
+    }
+
+    if (pre_rasterization) {
+        writer.write(info.pTessellationState ? info.pTessellationState->patchControlPoints : 0);
+
+        // static viewports are a part of the state unless they are dynamic
+        auto const &viewport_state = *info.pViewportState;
+        writer.write_array(viewport_state.pViewports, viewport_state.viewportCount, [&writer](auto const &viewport) {
+            writer.write(viewport.x);
+            writer.write(viewport.y);
+            writer.write(viewport.width);
+            writer.write(viewport.height);
+            writer.write(viewport.minDepth);
+            writer.write(viewport.maxDepth);
+        });
+        writer.write_array(viewport_state.pScissors, viewport_state.scissorCount, [&writer](auto const &scissor) {
+            writer.write(static_cast<uint32_t>(scissor.offset.x));
+            writer.write(static_cast<uint32_t>(scissor.offset.y));
+            writer.write(scissor.extent.width);
+            writer.write(scissor.extent.height);
+        });
+
+        auto const &rasterization = *info.pRasterizationState;
+        writer.write(rasterization.depthClampEnable);
+        writer.write(rasterization.rasterizerDiscardEnable);
+        writer.write(rasterization.polygonMode);
+        writer.write(rasterization.cullMode);
+        writer.write(rasterization.frontFace);
+        writer.write(rasterization.depthBiasEnable);
+        writer.write(rasterization.depthBiasConstantFactor);
+        writer.write(rasterization.depthBiasClamp);
+        writer.write(rasterization.depthBiasSlopeFactor);
+        writer.write(rasterization.lineWidth);
+    }
+
+    if (fragment_shader || fragment_output) {
+        auto const &multisample = *info.pMultisampleState;
+        writer.write(multisample.rasterizationSamples);
+        writer.write(multisample.sampleShadingEnable);
+        writer.write(multisample.minSampleShading);
+        writer.write(multisample.alphaToCoverageEnable);
+        writer.write(multisample.alphaToOneEnable);
+    }
+
+    if (fragment_shader) {
+        if (auto depth_stencil = info.pDepthStencilState) {
+            writer.write(depth_stencil->depthTestEnable);
+            writer.write(depth_stencil->depthWriteEnable);
+            writer.write(depth_stencil->depthCompareOp);
+            writer.write(depth_stencil->depthBoundsTestEnable);
+            writer.write(depth_stencil->stencilTestEnable);
+            write_stencil_state(writer, depth_stencil->front);
+            write_stencil_state(writer, depth_stencil->back);
+            writer.write(depth_stencil->minDepthBounds);
+            writer.write(depth_stencil->maxDepthBounds);
+        } else {
+            writer.write(uint64_t{0});
+        }
+    }
+
+    if (fragment_output) {
+        auto const &color_blend = *info.pColorBlendState;
+        writer.write(color_blend.logicOpEnable);
+        writer.write(color_blend.logicOp);
+        writer.write_array(color_blend.pAttachments, color_blend.attachmentCount, [&writer](auto const &attachment) {
+            writer.write(attachment.blendEnable);
+            writer.write(attachment.srcColorBlendFactor);
+            writer.write(attachment.dstColorBlendFactor);
+            writer.write(attachment.colorBlendOp);
+            writer.write(attachment.srcAlphaBlendFactor);
+            writer.write(attachment.dstAlphaBlendFactor);
+            writer.write(attachment.alphaBlendOp);
+            writer.write(attachment.colorWriteMask);
+        });
+        for (float constant : color_blend.blendConstants) {
+            writer.write(constant);
+        }
+    }
+
+    if (auto dynamic_state = info.pDynamicState) {
+        writer.write_array(
+            dynamic_state->pDynamicStates, dynamic_state->dynamicStateCount, [&writer](auto state) { writer.write(state); });
+    } else {
+        writer.write(uint64_t{0});
+    }
+
+    if (pre_rasterization || fragment_shader) {
+        writer.write(reinterpret_cast<uint64_t>(info.layout));
+    }
+    if (pre_rasterization || fragment_shader || fragment_output) {
+        // handle of the render pass is used when its compatibility is unknown
+        uint64_t render_pass_key = builder.get_render_pass_key();
+        writer.write(render_pass_key != 0 ? render_pass_key : reinterpret_cast<uint64_t>(info.renderPass));
+        writer.write(info.subpass);
+    }
+
+    hash_ = hash_bytes(std::as_bytes(std::span(words_)));
+}
+
+uint64_t get_render_pass_compatibility_key(VkRenderPassCreateInfo const &info) {
+    std::vector<uint64_t> words;
+    DescriptionWriter writer{words};
+    // formats and samples of the attachments and their references define the compatibility
+    writer.write_array(info.pAttachments, info.attachmentCount, [&writer](auto const &attachment) {
+        writer.write(attachment.format);
+        writer.write(attachment.samples);
+    });
+    writer.write_array(info.pSubpasses, info.subpassCount, [&writer](auto const &subpass) {
+        writer.write(subpass.pipelineBindPoint);
+        writer.write_array(subpass.pInputAttachments, subpass.inputAttachmentCount, [&writer](auto const &reference) {
+            write_attachment_reference(writer, reference);
+        });
+        writer.write_array(subpass.pColorAttachments, subpass.colorAttachmentCount, [&writer](auto const &reference) {
+            write_attachment_reference(writer, reference);
+        });
+        uint32_t resolve_count = subpass.pResolveAttachments ? subpass.colorAttachmentCount : 0;
+        writer.write_array(subpass.pResolveAttachments, resolve_count, [&writer](auto const &reference) {
+            write_attachment_reference(writer, reference);
+        });
+        writer.write(subpass.pDepthStencilAttachment ? subpass.pDepthStencilAttachment->attachment : VK_ATTACHMENT_UNUSED);
+    });
+    writer.write_array(info.pDependencies, info.dependencyCount, [&writer](auto const &dependency) {
+        writer.write(dependency.srcSubpass);
+        writer.write(dependency.dstSubpass);
+        writer.write(dependency.srcStageMask);
+        writer.write(dependency.dstStageMask);
+        writer.write(dependency.srcAccessMask);
+        writer.write(dependency.dstAccessMask);
+        writer.write(dependency.dependencyFlags);
+    });
+    return PipelineDescription::hash_bytes(std::as_bytes(std::span(words)));
+}
@@ -0,0 +1,42 @@
+#pragma once
+
+#include "graphics_types.hpp"
+
+#include <cstddef>
+#include <span>
+#include <vector>
+
+class PipelineBuilder;
+
+// canonical state of the pipeline, equal descriptions produce interchangeable pipelines
+class PipelineDescription {
+    std::vector<uint64_t> words_;
+    uint64_t hash_ = 0;
+
+  public:
+    explicit PipelineDescription(PipelineBuilder const &builder);
+
+    // describes only the state of the pipeline library parts
+    PipelineDescription(PipelineBuilder const &builder, VkGraphicsPipelineLibraryFlagsEXT parts);
+
+    uint64_t get_hash() const {
+        return hash_;
+    }
+
+    bool operator==(PipelineDescription const &other) const {
+        return hash_ == other.hash_ && words_ == other.words_;
+    }
+
+    // hash of the bytes which is stable between launches
+    static uint64_t hash_bytes(std::span<std::byte const> bytes, uint64_t seed = 0);
+};
+
+// pipelines are compatible with the render passes which have equal keys
+uint64_t get_render_pass_compatibility_key(VkRenderPassCreateInfo const &info);
+
+template <>
+struct std::hash<PipelineDescription> {
+    size_t operator()(PipelineDescription const &description) const {
+        return static_cast<size_t>(description.get_hash());
+    }
+};
@@ -0,0 +1,187 @@
+#include "pipeline_registry.hpp"
+
+#include "utility/log.hpp"
+#include "utility/trace.hpp"
+
+#include <algorithm>
+#include <array>
+
+namespace {
+
+    constexpr std::array<VkGraphicsPipelineLibraryFlagBitsEXT, 4> library_parts{
+        VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT,
+        VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT,
+        VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT,
+        VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT,
+    };
+
+    // the descriptions refer to the handle of the pipeline layout so the layout lives as long as the pipeline, otherwise
+    // the recycled handle of a new layout could match the stale entry
+    struct PipelineHolder {
+        shared_ptr_of<VkPipeline> pipeline;
+        shared_ptr_of<VkPipelineLayout> pipeline_layout;
+        std::vector<shared_ptr_of<VkPipeline>> libraries;
+    };
+
+    shared_ptr_of<VkPipeline> hold_pipeline(shared_ptr_of<VkPipeline> pipeline,
+                                            PipelineBuilder const &builder,
+                                            std::vector<shared_ptr_of<VkPipeline>> libraries = {}) {
+        VkPipeline handle = pipeline.get();
+        auto holder = std::make_shared<PipelineHolder>(PipelineHolder{
+            .pipeline = std::move(pipeline),
+            .pipeline_layout = builder.get_pipeline_layout(),
+            .libraries = std::move(libraries),
+        });
+        return shared_ptr_of<VkPipeline>(holder, handle);
+    }
+
+    std::vector<VkPipeline> get_handles(std::vector<shared_ptr_of<VkPipeline>> const &libraries) {
+        std::vector<VkPipeline> handles;
+        handles.reserve(libraries.size());
+        for (auto const &library : libraries) {
+            handles.push_back(library.get());
+        }
+        return handles;
+    }
+
+} // namespace
+
+PipelineRegistry::PipelineRegistry(bool pipeline_library)
+    : pipeline_library_{pipeline_library} {
+    info_println("Link pipelines from the libraries: {}", pipeline_library_);
+}
+
+PipelineRegistry::Entry *PipelineRegistry::find_entry(PipelineDescription const &description) {
+    auto iter = pipelines_.find(description);
+    if (iter == pipelines_.end() || iter->second.pipeline.expired()) {
+        return nullptr;
+    }
+    return &iter->second;
+}
+
+PipelineRegistry::LinkResult
+PipelineRegistry::insert_pipeline(PipelineDescription &&description, shared_ptr_of<VkPipeline> pipeline, bool optimized) {
+    std::lock_guard lock{mutex_};
+    // the equal pipeline could be compiled by another thread meanwhile, the optimized one replaces the fast linked one
+    if (auto entry = find_entry(description); entry && (entry->optimized || !optimized)) {
+        if (auto existing = entry->pipeline.lock()) {
+            return LinkResult{.pipeline = std::move(existing), .optimized = entry->optimized};
+        }
+    }
+    std::erase_if(pipelines_, [](auto const &entry) { return entry.second.pipeline.expired(); });
+    std::erase_if(libraries_, [](auto const &entry) { return entry.second.expired(); });
+    pipelines_.insert_or_assign(std::move(description), Entry{.pipeline = pipeline, .optimized = optimized});
+    return LinkResult{.pipeline = std::move(pipeline), .optimized = optimized};
+}
+
+shared_ptr_of<VkPipeline> PipelineRegistry::get_pipeline(PipelineBuilder const &builder) {
+    PipelineDescription description{builder};
+    {
+        std::lock_guard lock{mutex_};
+        if (auto entry = find_entry(description)) {
+            if (auto pipeline = entry->pipeline.lock()) {
+                ++statistics_.hits;
+                return pipeline;
+            }
+        }
+        ++statistics_.misses;
+    }
+    // pipelines are compiled without the lock so the registry does not serialize the compilation
+    return insert_pipeline(std::move(description), hold_pipeline(builder.make_pipeline(), builder), true).pipeline;
+}
+
+std::vector<shared_ptr_of<VkPipeline>> PipelineRegistry::get_libraries(PipelineBuilder const &builder) {
+    std::vector<shared_ptr_of<VkPipeline>> libraries;
+    for (auto part : library_parts) {
+        PipelineDescription description{builder, static_cast<VkGraphicsPipelineLibraryFlagsEXT>(part)};
+        {
+            std::lock_guard lock{mutex_};
+            if (auto iter = libraries_.find(description); iter != libraries_.end()) {
+                if (auto library = iter->second.lock()) {
+                    libraries.push_back(std::move(library));
+                    continue;
+                }
+            }
+        }
+        shared_ptr_of<VkPipeline> library;
+        {
+            trace_zone("make_pipeline_library");
+            library = hold_pipeline(builder.make_library(part), builder);
+        }
+        std::lock_guard lock{mutex_};
+        // the equal part could be compiled by another thread meanwhile
+        auto &entry = libraries_[std::move(description)];
+        if (auto existing = entry.lock()) {
+            library = std::move(existing);
+        } else {
+            entry = library;
+        }
+        libraries.push_back(std::move(library));
+    }
+    return libraries;
+}
+
+PipelineRegistry::LinkResult PipelineRegistry::link_pipeline(PipelineBuilder const &builder) {
+    if (!pipeline_library_) {
+        return LinkResult{.pipeline = get_pipeline(builder), .optimized = true};
+    }
+    PipelineDescription description{builder};
+    {
+        std::lock_guard lock{mutex_};
+        if (auto entry = find_entry(description)) {
+            if (auto pipeline = entry->pipeline.lock()) {
+                ++statistics_.hits;
+                return LinkResult{.pipeline = std::move(pipeline), .optimized = entry->optimized};
+            }
+        }
+        ++statistics_.misses;
+    }
+    // only the parts which have not been seen before are compiled
+    auto libraries = get_libraries(builder);
+    shared_ptr_of<VkPipeline> pipeline;
+    {
+        trace_zone("fast_link_pipeline");
+        pipeline = hold_pipeline(builder.link_libraries(get_handles(libraries), false), builder, std::move(libraries));
+    }
+    {
+        std::lock_guard lock{mutex_};
+        ++statistics_.fast_links;
+    }
+    return insert_pipeline(std::move(description), std::move(pipeline), false);
+}
+
+shared_ptr_of<VkPipeline> PipelineRegistry::optimize_pipeline(PipelineBuilder const &builder) {
+    if (!pipeline_library_) {
+        return get_pipeline(builder);
+    }
+    PipelineDescription description{builder};
+    {
+        std::lock_guard lock{mutex_};
+        if (auto entry = find_entry(description); entry && entry->optimized) {
+            if (auto pipeline = entry->pipeline.lock()) {
+                return pipeline;
+            }
+        }
+    }
+    auto libraries = get_libraries(builder);
+    shared_ptr_of<VkPipeline> pipeline;
+    {
+        trace_zone("optimize_pipeline");
+        pipeline = hold_pipeline(builder.link_libraries(get_handles(libraries), true), builder, std::move(libraries));
+    }
+    {
+        std::lock_guard lock{mutex_};
+        ++statistics_.optimized_links;
+    }
+    return insert_pipeline(std::move(description), std::move(pipeline), true).pipeline;
+}
+
+PipelineRegistry::Statistics PipelineRegistry::get_statistics() const {
+    std::lock_guard lock{mutex_};
+    Statistics statistics = statistics_;
+    statistics.pipelines_count = static_cast<size_t>(std::count_if(
+        pipelines_.begin(), pipelines_.end(), [](auto const &entry) { return !entry.second.pipeline.expired(); }));
+    statistics.libraries_count = static_cast<size_t>(
+        std::count_if(libraries_.begin(), libraries_.end(), [](auto const &entry) { return !entry.second.expired(); }));
+    return statistics;
+}
@@ -0,0 +1,67 @@
+#pragma once
+
+#include "pipeline_builder.hpp"
+#include "pipeline_description.hpp"
+
+#include <mutex>
+#include <unordered_map>
+
+// shares the pipelines of the builders with equal descriptions instead of compiling them again
+class PipelineRegistry {
+  public:
+    struct Statistics {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        // pipelines which are still in use
+        size_t pipelines_count = 0;
+        size_t libraries_count = 0;
+        uint64_t fast_links = 0;
+        uint64_t optimized_links = 0;
+    };
+
+    struct LinkResult {
+        shared_ptr_of<VkPipeline> pipeline;
+        // false if the pipeline has been linked without the link time optimization
+        bool optimized;
+    };
+
+  private:
+    struct Entry {
+        // pipelines are released by their users so the registry does not keep them alive
+        std::weak_ptr<ptr_value_type<VkPipeline>> pipeline;
+        bool optimized = true;
+    };
+
+    bool pipeline_library_;
+    mutable std::mutex mutex_;
+    std::unordered_map<PipelineDescription, Entry> pipelines_;
+    // the parts are shared by many pipelines which keep them alive, so they are released with the last pipeline
+    std::unordered_map<PipelineDescription, std::weak_ptr<ptr_value_type<VkPipeline>>> libraries_;
+    Statistics statistics_;
+
+    Entry *find_entry(PipelineDescription const &description);
+
+    LinkResult insert_pipeline(PipelineDescription &&description, shared_ptr_of<VkPipeline> pipeline, bool optimized);
+
+    std::vector<shared_ptr_of<VkPipeline>> get_libraries(PipelineBuilder const &builder);
+
+  public:
+    // the pipelines are linked from the parts of VK_EXT_graphics_pipeline_library if it's enabled
+    explicit PipelineRegistry(bool pipeline_library = false);
+
+    bool is_pipeline_library_enabled() const {
+        return pipeline_library_;
+    }
+
+    // compiles the pipeline on the calling thread if there is no equal one, may be called from any thread
+    shared_ptr_of<VkPipeline> get_pipeline(PipelineBuilder const &builder);
+
+    // links the cached parts without the optimization if there is no equal pipeline,
+    // falls back to the compilation of the complete pipeline if the library is not enabled
+    LinkResult link_pipeline(PipelineBuilder const &builder);
+
+    // links the parts with the link time optimization and replaces the fast linked pipeline for the next requests
+    shared_ptr_of<VkPipeline> optimize_pipeline(PipelineBuilder const &builder);
+
+    Statistics get_statistics() const;
+};
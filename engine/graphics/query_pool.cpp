@@ -0,0 +1,95 @@
+#include "query_pool.hpp"
+
+#include "graphics_error.hpp"
+#include "graphics_manager.hpp"
+
+#include <bit>
+
+QueryPool::QueryPool(shared_ptr_of<VkDevice> device, VkQueryType type, uint32_t queries_count, VkQueryPipelineStatisticFlags statistic_flags)
+    : device_{device}
+    , type_{type}
+    , queries_count_{queries_count}
+    , values_count_{type == VK_QUERY_TYPE_PIPELINE_STATISTICS ? static_cast<uint32_t>(std::popcount(statistic_flags)) : 1} {
+    VkQueryPoolCreateInfo info{
+        .sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO,
+        .queryType = type,
+        .queryCount = queries_count,
+        .pipelineStatistics = statistic_flags,
+    };
+    query_pool_ = GraphicsManager::make_query_pool(device, info);
+}
+
+QueryPool QueryPool::make_timestamp_pool(shared_ptr_of<VkDevice> device, uint32_t queries_count) {
+    return QueryPool(device, VK_QUERY_TYPE_TIMESTAMP, queries_count);
+}
+
+QueryPool QueryPool::make_occlusion_pool(shared_ptr_of<VkDevice> device, uint32_t queries_count, bool precise_supported) {
+    QueryPool query_pool(device, VK_QUERY_TYPE_OCCLUSION, queries_count);
+    query_pool.precise_supported_ = precise_supported;
+    return query_pool;
+}
+
+QueryPool QueryPool::make_pipeline_statistics_pool(shared_ptr_of<VkDevice> device, uint32_t queries_count) {
+    return QueryPool(device, VK_QUERY_TYPE_PIPELINE_STATISTICS, queries_count, PipelineStatistics::flags);
+}
+
+void QueryPool::reset(VkCommandBuffer command_buffer) const {
+    vkCmdResetQueryPool(command_buffer, query_pool_.get(), 0, queries_count_);
+}
+
+void QueryPool::begin(VkCommandBuffer command_buffer, uint32_t query, bool precise) const {
+    if (precise && (type_ != VK_QUERY_TYPE_OCCLUSION || !precise_supported_)) {
+        raise_error("Precise queries require the occlusion pool of the device with occlusionQueryPrecise.");
+    }
+    VkQueryControlFlags flags = precise ? VK_QUERY_CONTROL_PRECISE_BIT : 0;
+    vkCmdBeginQuery(command_buffer, query_pool_.get(), query, flags);
+}
+
+void QueryPool::end(VkCommandBuffer command_buffer, uint32_t query) const {
+    vkCmdEndQuery(command_buffer, query_pool_.get(), query);
+}
+
+void QueryPool::write_timestamp(VkCommandBuffer command_buffer, VkPipelineStageFlagBits stage, uint32_t query) const {
+    vkCmdWriteTimestamp(command_buffer, stage, query_pool_.get(), query);
+}
+
+std::vector<std::optional<QueryPool::values_t>> QueryPool::get_results(uint32_t first_query, uint32_t queries_count) const {
+    std::vector<std::optional<values_t>> results(queries_count);
+    if (queries_count == 0) {
+        return results;
+    }
+    // every query is followed by its availability so the call never blocks
+    size_t stride = values_count_ + 1;
+    values_t data(queries_count * stride);
+    VkResult result = vkGetQueryPoolResults(device_.get(),
+                                            query_pool_.get(),
+                                            first_query,
+                                            queries_count,
+                                            data.size() * sizeof(uint64_t),
+                                            data.data(),
+                                            stride * sizeof(uint64_t),
+                                            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    if (result != VK_NOT_READY) {
+        vk_assert(result, "Failed to get query pool results.");
+    }
+    for (uint32_t i = 0; i < queries_count; ++i) {
+        auto begin = data.begin() + i * stride;
+        if (begin[values_count_] != 0) {
+            results[i] = values_t(begin, begin + values_count_);
+        }
+    }
+    return results;
+}
+
+PipelineStatistics QueryPool::to_pipeline_statistics(values_t const &values) {
+    if (values.size() < 5) {
+        raise_error("Unexpected pipeline statistics values count {}.", values.size());
+    }
+    return PipelineStatistics{
+        .input_vertices = values[0],
+        .vertex_invocations = values[1],
+        .clipping_invocations = values[2],
+        .clipping_primitives = values[3],
+        .fragment_invocations = values[4],
+    };
+}
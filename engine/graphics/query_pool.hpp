@@ -0,0 +1,77 @@
+#pragma once
+
+#include "graphics_types.hpp"
+
+#include <optional>
+#include <vector>
+
+// counters of the pipeline stages in the order of the queried statistic flags
+struct PipelineStatistics {
+    uint64_t input_vertices = 0;
+    uint64_t vertex_invocations = 0;
+    uint64_t clipping_invocations = 0;
+    uint64_t clipping_primitives = 0;
+    uint64_t fragment_invocations = 0;
+
+    static constexpr VkQueryPipelineStatisticFlags flags =
+        VK_QUERY_PIPELINE_STATISTIC_INPUT_ASSEMBLY_VERTICES_BIT | VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_CLIPPING_INVOCATIONS_BIT | VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT |
+        VK_QUERY_PIPELINE_STATISTIC_FRAGMENT_SHADER_INVOCATIONS_BIT;
+};
+
+class QueryPool {
+  public:
+    using values_t = std::vector<uint64_t>;
+
+  private:
+    shared_ptr_of<VkDevice> device_;
+    unique_ptr_of<VkQueryPool> query_pool_;
+    VkQueryType type_;
+    uint32_t queries_count_;
+    // every pipeline statistics query has a value per statistic flag
+    uint32_t values_count_;
+    // the precise occlusion requires the feature of the device
+    bool precise_supported_ = false;
+
+  public:
+    QueryPool(shared_ptr_of<VkDevice> device, VkQueryType type, uint32_t queries_count, VkQueryPipelineStatisticFlags statistic_flags = 0);
+
+    static QueryPool make_timestamp_pool(shared_ptr_of<VkDevice> device, uint32_t queries_count);
+
+    // the precise queries are allowed if the device has enabled them, see DeviceContext::is_precise_occlusion_supported
+    static QueryPool make_occlusion_pool(shared_ptr_of<VkDevice> device, uint32_t queries_count, bool precise_supported = false);
+
+    static QueryPool make_pipeline_statistics_pool(shared_ptr_of<VkDevice> device, uint32_t queries_count);
+
+    VkQueryPool get_query_pool() const {
+        return query_pool_.get();
+    }
+
+    VkQueryType get_type() const {
+        return type_;
+    }
+
+    uint32_t get_queries_count() const {
+        return queries_count_;
+    }
+
+    uint32_t get_values_count() const {
+        return values_count_;
+    }
+
+    // must be recorded outside of a render pass
+    void reset(VkCommandBuffer command_buffer) const;
+
+    // precise occlusion counts the samples instead of reporting only whether any sample has passed, raises an error if the
+    // pool does not support it
+    void begin(VkCommandBuffer command_buffer, uint32_t query, bool precise = false) const;
+
+    void end(VkCommandBuffer command_buffer, uint32_t query) const;
+
+    void write_timestamp(VkCommandBuffer command_buffer, VkPipelineStageFlagBits stage, uint32_t query) const;
+
+    // reads the results without waiting, the queries which are not available yet are empty
+    std::vector<std::optional<values_t>> get_results(uint32_t first_query, uint32_t queries_count) const;
+
+    static PipelineStatistics to_pipeline_statistics(values_t const &values);
+};
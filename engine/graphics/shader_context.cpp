@@ -2,39 +2,37 @@
 
 #include "graphics_error.hpp"
 #include "graphics_manager.hpp"
+#include "pipeline_description.hpp"
 
-#include <fstream>
-
-namespace {
-
-    std::vector<uint8_t> read_shader(std::string_view filename) {
-        std::ifstream fin{filename.data(), std::ios::ate | std::ios::binary};
-        if (!fin.is_open()) {
-            raise_error("Failed to open shader file {}", filename);
-        }
-        std::vector<uint8_t> buffer(static_cast<size_t>(fin.tellg()));
-        fin.seekg(0);
-        fin.read(reinterpret_cast<char *>(buffer.data()), buffer.size());
-        fin.close();
-        return buffer;
-    }
-
-} // namespace
+#include "utility/mapped_file.hpp"
 
 ShaderContext::ShaderContext(shared_ptr_of<VkDevice> device, std::string_view filename, VkShaderStageFlagBits stage)
     : stage_{stage} {
-    auto buffer = read_shader(filename);
-    VkShaderModuleCreateInfo info{
-        .sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO,
-        .codeSize = buffer.size(),
-        .pCode = reinterpret_cast<uint32_t const *>(buffer.data()),
-    };
-    VkShaderModule shader_module;
-    vk_assert(vkCreateShaderModule(device.get(), &info, nullptr, &shader_module), "Failed to create a shader module.");
-    shader_module_ = unique_ptr_of<VkShaderModule>(shader_module, [device](VkShaderModule shader_module) {
-        debug_println("delete shader module");
-        vkDestroyShaderModule(device.get(), shader_module, nullptr);
-    });
+    // the mapping is aligned to the page so the code is passed without copying
+    MappedFile file{filename};
+    code_hash_ = PipelineDescription::hash_bytes(file.get_data());
+    auto words = get_code_words(file.get_data());
+    shader_module_ = GraphicsManager::make_shader_module(device, words);
+    reflection_ = std::make_shared<ShaderReflection const>(words);
+}
+
+ShaderContext::ShaderContext(shared_ptr_of<VkDevice> device, std::span<uint32_t const> code, VkShaderStageFlagBits stage)
+    : shader_module_{GraphicsManager::make_shader_module(device, get_code_words(std::as_bytes(code)))}
+    , stage_{stage}
+    , code_hash_{PipelineDescription::hash_bytes(std::as_bytes(code))}
+    , reflection_{std::make_shared<ShaderReflection const>(code)} {
+}
+
+ShaderContext::ShaderContext(shared_ptr_of<VkShaderModule> shader_module,
+                             VkShaderStageFlagBits stage,
+                             uint64_t code_hash,
+                             std::shared_ptr<ShaderReflection const> reflection,
+                             std::vector<uint8_t> module_identifier)
+    : shader_module_{std::move(shader_module)}
+    , stage_{stage}
+    , code_hash_{code_hash}
+    , reflection_{std::move(reflection)}
+    , module_identifier_{std::move(module_identifier)} {
 }
 
 VkPipelineShaderStageCreateInfo ShaderContext::get_shader_stage() const {
@@ -42,6 +40,28 @@ VkPipelineShaderStageCreateInfo ShaderContext::get_shader_stage() const {
         .sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO,
         .stage = stage_,
         .module = shader_module_.get(),
-        .pName = "main",
+        .pName = entry_point_.c_str(),
+        .pSpecializationInfo = specialization_.get_info(),
     };
 }
+
+ShaderContext ShaderContext::specialize(SpecializationConstants const &constants) const {
+    ShaderContext shader{*this};
+    shader.specialization_ = constants;
+    return shader;
+}
+
+std::span<uint32_t const> ShaderContext::get_code_words(std::span<std::byte const> data) {
+    uint32_t constexpr magic_number = 0x07230203;
+    if (data.size() < sizeof(uint32_t) || data.size() % sizeof(uint32_t) != 0) {
+        raise_error("Invalid SPIR-V size {}", data.size());
+    }
+    if (reinterpret_cast<uintptr_t>(data.data()) % alignof(uint32_t) != 0) {
+        raise_error("SPIR-V code is not aligned");
+    }
+    auto words = std::span(reinterpret_cast<uint32_t const *>(data.data()), data.size() / sizeof(uint32_t));
+    if (words.front() != magic_number) {
+        raise_error("Invalid SPIR-V magic number {:#x}", words.front());
+    }
+    return words;
+}
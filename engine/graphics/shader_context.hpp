@@ -1,15 +1,80 @@
 #pragma once
 
 #include "graphics_types.hpp"
+#include "shader_reflection.hpp"
+#include "specialization_constants.hpp"
 
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <string>
 #include <string_view>
+#include <vector>
 
 class ShaderContext {
-    unique_ptr_of<VkShaderModule> shader_module_;
+    shared_ptr_of<VkShaderModule> shader_module_;
     VkShaderStageFlagBits stage_;
+    uint64_t code_hash_;
+    std::string entry_point_ = "main";
+    SpecializationConstants specialization_;
+    std::shared_ptr<ShaderReflection const> reflection_;
+    // identifier of VK_EXT_shader_module_identifier, empty if the extension is not enabled
+    std::vector<uint8_t> module_identifier_;
 
   public:
     ShaderContext(shared_ptr_of<VkDevice> device, std::string_view filename, VkShaderStageFlagBits stage);
 
+    // the code is usually embedded into the binary so no file is read
+    ShaderContext(shared_ptr_of<VkDevice> device, std::span<uint32_t const> code, VkShaderStageFlagBits stage);
+
+    // the module may be shared by several shaders, see ShaderLibrary
+    ShaderContext(shared_ptr_of<VkShaderModule> shader_module,
+                  VkShaderStageFlagBits stage,
+                  uint64_t code_hash,
+                  std::shared_ptr<ShaderReflection const> reflection,
+                  std::vector<uint8_t> module_identifier = {});
+
+    // the stage points to the entry point and the constants of this object
     VkPipelineShaderStageCreateInfo get_shader_stage() const;
-};
\ No newline at end of file
+
+    // permutation of the shader which shares its module
+    ShaderContext specialize(SpecializationConstants const &constants) const;
+
+    void set_entry_point(std::string entry_point) {
+        entry_point_ = std::move(entry_point);
+    }
+
+    std::string const &get_entry_point() const {
+        return entry_point_;
+    }
+
+    SpecializationConstants const &get_specialization() const {
+        return specialization_;
+    }
+
+    VkShaderStageFlagBits get_stage() const {
+        return stage_;
+    }
+
+    shared_ptr_of<VkShaderModule> const &get_shader_module() const {
+        return shader_module_;
+    }
+
+    // resources of the module parsed when it has been loaded
+    ShaderReflection const &get_reflection() const {
+        return *reflection_;
+    }
+
+    // may be passed to the pipeline instead of the module to create it from the pipeline cache only
+    std::vector<uint8_t> const &get_module_identifier() const {
+        return module_identifier_;
+    }
+
+    // identifies the shader code regardless of the module it has been loaded to
+    uint64_t get_code_hash() const {
+        return code_hash_;
+    }
+
+    // reinterprets the SPIR-V binary as words, the data has to be aligned to the word boundary
+    static std::span<uint32_t const> get_code_words(std::span<std::byte const> data);
+};
@@ -0,0 +1,109 @@
+#include "shader_library.hpp"
+
+#include "graphics_error.hpp"
+#include "graphics_manager.hpp"
+#include "pipeline_description.hpp"
+
+#include "utility/mapped_file.hpp"
+#include "utility/trace.hpp"
+
+#include <algorithm>
+#include <utility>
+
+ShaderLibrary::ShaderLibrary(DeviceContext const &device_context)
+    : device_{device_context.get_device()} {
+    // the pipelines created from the identifiers have to fail instead of compiling, which needs the cache control
+    auto const &features = device_context.get_features();
+    if (device_context.is_extension_enabled(VK_EXT_SHADER_MODULE_IDENTIFIER_EXTENSION_NAME) &&
+        features.shader_module_identifier.shaderModuleIdentifier == VK_TRUE &&
+        features.pipeline_cache_control.pipelineCreationCacheControl == VK_TRUE) {
+        get_module_identifier_ = reinterpret_cast<PFN_vkGetShaderModuleIdentifierEXT>(
+            vkGetDeviceProcAddr(device_.get(), "vkGetShaderModuleIdentifierEXT"));
+    }
+}
+
+ShaderLibrary::Module const &ShaderLibrary::get_module(uint64_t code_hash, std::span<uint32_t const> code) {
+    if (auto iter = modules_.find(code_hash); iter != modules_.end()) {
+        ++statistics_.hits;
+        return iter->second;
+    }
+    Module module{
+        .shader_module = GraphicsManager::make_shader_module(device_, code),
+        .reflection = std::make_shared<ShaderReflection const>(code),
+    };
+    if (get_module_identifier_) {
+        VkShaderModuleIdentifierEXT identifier{.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_IDENTIFIER_EXT};
+        get_module_identifier_(device_.get(), module.shader_module.get(), &identifier);
+        module.identifier.assign(identifier.identifier, identifier.identifier + identifier.identifierSize);
+    }
+    statistics_.loaded_bytes += code.size_bytes();
+    return modules_.emplace(code_hash, std::move(module)).first->second;
+}
+
+ShaderContext ShaderLibrary::get_shader(std::filesystem::path const &filename, VkShaderStageFlagBits stage) {
+    trace_zone("get_shader");
+    std::string key = std::filesystem::weakly_canonical(filename).string();
+    std::lock_guard lock{mutex_};
+    if (auto iter = files_.find(key); iter != files_.end()) {
+        ++statistics_.hits;
+        Module const &module = modules_.at(iter->second);
+        return ShaderContext{module.shader_module, stage, iter->second, module.reflection, module.identifier};
+    }
+    MappedFile file{filename};
+    uint64_t code_hash = PipelineDescription::hash_bytes(file.get_data());
+    Module const &module = get_module(code_hash, ShaderContext::get_code_words(file.get_data()));
+    files_.emplace(std::move(key), code_hash);
+    ++statistics_.files_count;
+    return ShaderContext{module.shader_module, stage, code_hash, module.reflection, module.identifier};
+}
+
+ShaderContext ShaderLibrary::get_shader(std::span<uint32_t const> code, VkShaderStageFlagBits stage) {
+    uint64_t code_hash = PipelineDescription::hash_bytes(std::as_bytes(code));
+    std::lock_guard lock{mutex_};
+    Module const &module = get_module(code_hash, code);
+    return ShaderContext{module.shader_module, stage, code_hash, module.reflection, module.identifier};
+}
+
+bool ShaderLibrary::reload(std::filesystem::path const &filename) {
+    trace_zone("reload_shader");
+    std::string key = std::filesystem::weakly_canonical(filename).string();
+    std::lock_guard lock{mutex_};
+    auto iter = files_.find(key);
+    if (iter == files_.end()) {
+        return false;
+    }
+    try {
+        MappedFile file{filename};
+        uint64_t code_hash = PipelineDescription::hash_bytes(file.get_data());
+        if (code_hash == iter->second) {
+            return false;
+        }
+        get_module(code_hash, ShaderContext::get_code_words(file.get_data()));
+        uint64_t old_hash = std::exchange(iter->second, code_hash);
+        // the shaders created before keep the old module alive
+        if (std::none_of(files_.begin(), files_.end(), [old_hash](auto const &entry) { return entry.second == old_hash; })) {
+            modules_.erase(old_hash);
+        }
+    } catch (std::exception const &ex) {
+        // the file may be still written by the compiler, the next change reloads it
+        error_println("Failed to reload shader {}: {}", key, ex.what());
+        return false;
+    }
+    ++statistics_.files_count;
+    ++version_;
+    info_println("Reload shader {}", key);
+    return true;
+}
+
+void ShaderLibrary::clear() {
+    std::lock_guard lock{mutex_};
+    modules_.clear();
+    files_.clear();
+}
+
+ShaderLibrary::Statistics ShaderLibrary::get_statistics() const {
+    std::lock_guard lock{mutex_};
+    Statistics statistics = statistics_;
+    statistics.modules_count = modules_.size();
+    return statistics;
+}
@@ -0,0 +1,69 @@
+#pragma once
+
+#include "device_context.hpp"
+#include "shader_context.hpp"
+
+#include <atomic>
+#include <filesystem>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+// shares the shader modules between the pipelines, the modules are deduplicated by the hash of their code
+class ShaderLibrary {
+  public:
+    struct Statistics {
+        // files which have been mapped and read
+        size_t files_count = 0;
+        size_t modules_count = 0;
+        size_t loaded_bytes = 0;
+        // requests satisfied with an existing module
+        uint64_t hits = 0;
+    };
+
+  private:
+    struct Module {
+        shared_ptr_of<VkShaderModule> shader_module;
+        // opaque identifier of VK_EXT_shader_module_identifier, empty if the extension is not enabled
+        std::vector<uint8_t> identifier;
+        std::shared_ptr<ShaderReflection const> reflection;
+    };
+
+    shared_ptr_of<VkDevice> device_;
+    PFN_vkGetShaderModuleIdentifierEXT get_module_identifier_ = nullptr;
+    mutable std::mutex mutex_;
+    std::unordered_map<uint64_t, Module> modules_;
+    // the files are read once, their code hashes refer to the modules
+    std::unordered_map<std::string, uint64_t> files_;
+    Statistics statistics_;
+    std::atomic<uint64_t> version_{0};
+
+    Module const &get_module(uint64_t code_hash, std::span<uint32_t const> code);
+
+  public:
+    explicit ShaderLibrary(DeviceContext const &device_context);
+
+    // may be called from any thread
+    ShaderContext get_shader(std::filesystem::path const &filename, VkShaderStageFlagBits stage);
+
+    ShaderContext get_shader(std::span<uint32_t const> code, VkShaderStageFlagBits stage);
+
+    // reads the loaded file again, returns true if its code has changed so the shaders have to be requested again
+    bool reload(std::filesystem::path const &filename);
+
+    // increases on every changed file
+    uint64_t get_version() const {
+        return version_;
+    }
+
+    // the shaders carry the identifiers of their modules which the pipeline builder tries before the modules
+    bool is_module_identifier_enabled() const {
+        return get_module_identifier_ != nullptr;
+    }
+
+    // the modules stay alive while the shaders refer to them
+    void clear();
+
+    Statistics get_statistics() const;
+};
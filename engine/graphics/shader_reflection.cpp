@@ -0,0 +1,511 @@
+#include "shader_reflection.hpp"
+
+#include "graphics_error.hpp"
+
+#include <algorithm>
+#include <optional>
+#include <tuple>
+#include <unordered_map>
+
+namespace {
+
+    // the subset of the SPIR-V specification the reflection needs
+    namespace spv {
+        uint32_t constexpr magic_number = 0x07230203;
+        uint32_t constexpr header_size = 5;
+
+        enum op : uint32_t {
+            op_name = 5,
+            op_entry_point = 15,
+            op_execution_mode = 16,
+            op_type_bool = 20,
+            op_type_int = 21,
+            op_type_float = 22,
+            op_type_vector = 23,
+            op_type_matrix = 24,
+            op_type_image = 25,
+            op_type_sampler = 26,
+            op_type_sampled_image = 27,
+            op_type_array = 28,
+            op_type_runtime_array = 29,
+            op_type_struct = 30,
+            op_type_pointer = 32,
+            op_constant = 43,
+            op_variable = 59,
+            op_decorate = 71,
+            op_member_decorate = 72,
+            op_type_acceleration_structure = 5341,
+        };
+
+        uint32_t constexpr execution_mode_local_size = 17;
+
+        enum decoration : uint32_t {
+            decoration_block = 2,
+            decoration_buffer_block = 3,
+            decoration_array_stride = 6,
+            decoration_matrix_stride = 7,
+            decoration_builtin = 11,
+            decoration_location = 30,
+            decoration_binding = 33,
+            decoration_descriptor_set = 34,
+            decoration_offset = 35,
+        };
+
+        enum storage_class : uint32_t {
+            storage_uniform_constant = 0,
+            storage_input = 1,
+            storage_uniform = 2,
+            storage_push_constant = 9,
+            storage_storage_buffer = 12,
+        };
+
+        enum dim : uint32_t {
+            dim_buffer = 5,
+            dim_subpass_data = 6,
+        };
+
+        VkShaderStageFlagBits get_stage(uint32_t execution_model) {
+            switch (execution_model) {
+            case 0:
+                return VK_SHADER_STAGE_VERTEX_BIT;
+            case 1:
+                return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+            case 2:
+                return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+            case 3:
+                return VK_SHADER_STAGE_GEOMETRY_BIT;
+            case 4:
+                return VK_SHADER_STAGE_FRAGMENT_BIT;
+            case 5:
+                return VK_SHADER_STAGE_COMPUTE_BIT;
+            }
+            raise_error("Unsupported SPIR-V execution model {}", execution_model);
+        }
+    } // namespace spv
+
+    std::string read_string(std::span<uint32_t const> words) {
+        std::string result;
+        for (uint32_t word : words) {
+            for (int i = 0; i < 4; ++i) {
+                char c = static_cast<char>((word >> (i * 8)) & 0xff);
+                if (c == '\0') {
+                    return result;
+                }
+                result.push_back(c);
+            }
+        }
+        return result;
+    }
+
+    // instructions of the module indexed by the result id
+    class ModuleParser {
+        struct Type {
+            uint32_t op = 0;
+            std::span<uint32_t const> operands;
+        };
+
+        struct Decorations {
+            std::optional<uint32_t> set;
+            std::optional<uint32_t> binding;
+            std::optional<uint32_t> location;
+            std::optional<uint32_t> array_stride;
+            bool builtin = false;
+            bool block = false;
+            bool buffer_block = false;
+            // member offsets and matrix strides of the structs
+            std::unordered_map<uint32_t, uint32_t> offsets;
+            std::unordered_map<uint32_t, uint32_t> matrix_strides;
+        };
+
+        struct Variable {
+            uint32_t id;
+            uint32_t type;
+            uint32_t storage_class;
+        };
+
+        std::unordered_map<uint32_t, Type> types_;
+        std::unordered_map<uint32_t, uint32_t> constants_;
+        std::unordered_map<uint32_t, Decorations> decorations_;
+        std::unordered_map<uint32_t, std::string> names_;
+        std::vector<Variable> variables_;
+        std::optional<uint32_t> execution_model_;
+        std::string entry_point_;
+        uint32_t entry_point_id_ = 0;
+        std::array<uint32_t, 3> local_size_{1, 1, 1};
+
+      public:
+        explicit ModuleParser(std::span<uint32_t const> code) {
+            if (code.size() < spv::header_size || code[0] != spv::magic_number) {
+                raise_error("Invalid SPIR-V module of {} words", code.size());
+            }
+            for (size_t offset = spv::header_size; offset < code.size();) {
+                uint32_t count = code[offset] >> 16;
+                uint32_t op = code[offset] & 0xffff;
+                if (count == 0 || offset + count > code.size()) {
+                    raise_error("Invalid SPIR-V instruction {} at word {}", op, offset);
+                }
+                parse_instruction(op, code.subspan(offset + 1, count - 1));
+                offset += count;
+            }
+            if (!execution_model_) {
+                raise_error("SPIR-V module has no entry point");
+            }
+        }
+
+        VkShaderStageFlagBits get_stage() const {
+            return spv::get_stage(*execution_model_);
+        }
+
+        std::string const &get_entry_point() const {
+            return entry_point_;
+        }
+
+        std::array<uint32_t, 3> const &get_local_size() const {
+            return local_size_;
+        }
+
+        std::vector<ShaderReflection::Binding> get_bindings() const {
+            std::vector<ShaderReflection::Binding> bindings;
+            for (auto const &variable : variables_) {
+                if (variable.storage_class != spv::storage_uniform_constant && variable.storage_class != spv::storage_uniform &&
+                    variable.storage_class != spv::storage_storage_buffer) {
+                    continue;
+                }
+                auto const &decorations = get_decorations(variable.id);
+                if (!decorations.binding) {
+                    continue;
+                }
+                uint32_t type_id = get_pointee(variable.type);
+                uint32_t count = 1;
+                // arrays of the resources occupy a single binding
+                while (is_type(type_id, spv::op_type_array) || is_type(type_id, spv::op_type_runtime_array)) {
+                    Type const &type = types_.at(type_id);
+                    // the unbounded arrays get their count from the descriptor set
+                    count = type.op == spv::op_type_array ? count * get_constant(type.operands[1]) : 0;
+                    type_id = type.operands[0];
+                }
+                bindings.push_back(ShaderReflection::Binding{
+                    .set = decorations.set.value_or(0),
+                    .binding =
+                        VkDescriptorSetLayoutBinding{
+                            .binding = *decorations.binding,
+                            .descriptorType = get_descriptor_type(variable.storage_class, type_id),
+                            .descriptorCount = count,
+                            .stageFlags = static_cast<VkShaderStageFlags>(get_stage()),
+                            .pImmutableSamplers = nullptr,
+                        },
+                    .name = get_name(variable.id),
+                });
+            }
+            std::sort(bindings.begin(), bindings.end(), [](auto const &left, auto const &right) {
+                return std::tie(left.set, left.binding.binding) < std::tie(right.set, right.binding.binding);
+            });
+            return bindings;
+        }
+
+        uint32_t get_push_constants_size() const {
+            for (auto const &variable : variables_) {
+                if (variable.storage_class == spv::storage_push_constant) {
+                    return get_size(get_pointee(variable.type), std::nullopt);
+                }
+            }
+            return 0;
+        }
+
+        std::vector<ShaderReflection::Input> get_inputs() const {
+            std::vector<ShaderReflection::Input> inputs;
+            if (*execution_model_ != 0) {
+                return inputs;
+            }
+            for (auto const &variable : variables_) {
+                auto const &decorations = get_decorations(variable.id);
+                if (variable.storage_class != spv::storage_input || decorations.builtin || !decorations.location) {
+                    continue;
+                }
+                uint32_t type_id = get_pointee(variable.type);
+                // the matrix takes a location per column
+                uint32_t columns = 1;
+                if (is_type(type_id, spv::op_type_matrix)) {
+                    columns = types_.at(type_id).operands[1];
+                    type_id = types_.at(type_id).operands[0];
+                }
+                for (uint32_t column = 0; column < columns; ++column) {
+                    inputs.push_back(ShaderReflection::Input{
+                        .location = *decorations.location + column,
+                        .format = get_format(type_id),
+                        .size = get_size(type_id, std::nullopt),
+                        .name = get_name(variable.id),
+                    });
+                }
+            }
+            std::sort(inputs.begin(), inputs.end(), [](auto const &left, auto const &right) { return left.location < right.location; });
+            return inputs;
+        }
+
+      private:
+        void parse_instruction(uint32_t op, std::span<uint32_t const> operands) {
+            switch (op) {
+            case spv::op_name:
+                names_[operands[0]] = read_string(operands.subspan(1));
+                break;
+            case spv::op_entry_point:
+                // the first entry point describes the module
+                if (!execution_model_) {
+                    execution_model_ = operands[0];
+                    entry_point_id_ = operands[1];
+                    entry_point_ = read_string(operands.subspan(2));
+                }
+                break;
+            case spv::op_execution_mode:
+                if (operands[0] == entry_point_id_ && operands[1] == spv::execution_mode_local_size) {
+                    local_size_ = {operands[2], operands[3], operands[4]};
+                }
+                break;
+            case spv::op_constant:
+                constants_[operands[1]] = operands[2];
+                break;
+            case spv::op_variable:
+                variables_.push_back(Variable{.id = operands[1], .type = operands[0], .storage_class = operands[2]});
+                break;
+            case spv::op_decorate:
+                parse_decoration(decorations_[operands[0]], operands[1], operands.subspan(2));
+                break;
+            case spv::op_member_decorate:
+                if (operands[2] == spv::decoration_offset) {
+                    decorations_[operands[0]].offsets[operands[1]] = operands[3];
+                } else if (operands[2] == spv::decoration_matrix_stride) {
+                    decorations_[operands[0]].matrix_strides[operands[1]] = operands[3];
+                }
+                break;
+            case spv::op_type_bool:
+            case spv::op_type_int:
+            case spv::op_type_float:
+            case spv::op_type_vector:
+            case spv::op_type_matrix:
+            case spv::op_type_image:
+            case spv::op_type_sampler:
+            case spv::op_type_sampled_image:
+            case spv::op_type_array:
+            case spv::op_type_runtime_array:
+            case spv::op_type_struct:
+            case spv::op_type_pointer:
+            case spv::op_type_acceleration_structure:
+                types_[operands[0]] = Type{.op = op, .operands = operands.subspan(1)};
+                break;
+            }
+        }
+
+        static void parse_decoration(Decorations &decorations, uint32_t decoration, std::span<uint32_t const> literals) {
+            switch (decoration) {
+            case spv::decoration_block:
+                decorations.block = true;
+                break;
+            case spv::decoration_buffer_block:
+                decorations.buffer_block = true;
+                break;
+            case spv::decoration_builtin:
+                decorations.builtin = true;
+                break;
+            case spv::decoration_array_stride:
+                decorations.array_stride = literals[0];
+                break;
+            case spv::decoration_location:
+                decorations.location = literals[0];
+                break;
+            case spv::decoration_binding:
+                decorations.binding = literals[0];
+                break;
+            case spv::decoration_descriptor_set:
+                decorations.set = literals[0];
+                break;
+            }
+        }
+
+        Decorations const &get_decorations(uint32_t id) const {
+            static Decorations const empty;
+            auto iter = decorations_.find(id);
+            return iter == decorations_.end() ? empty : iter->second;
+        }
+
+        std::string get_name(uint32_t id) const {
+            auto iter = names_.find(id);
+            return iter == names_.end() ? std::string{} : iter->second;
+        }
+
+        bool is_type(uint32_t id, uint32_t op) const {
+            auto iter = types_.find(id);
+            return iter != types_.end() && iter->second.op == op;
+        }
+
+        Type const &get_type(uint32_t id) const {
+            auto iter = types_.find(id);
+            if (iter == types_.end()) {
+                raise_error("Unknown SPIR-V type {}", id);
+            }
+            return iter->second;
+        }
+
+        uint32_t get_pointee(uint32_t pointer_id) const {
+            return get_type(pointer_id).operands[1];
+        }
+
+        uint32_t get_constant(uint32_t id) const {
+            auto iter = constants_.find(id);
+            if (iter == constants_.end()) {
+                // the length may be a specialization constant which is unknown until the pipeline is created
+                raise_error("SPIR-V array length {} is not a constant", id);
+            }
+            return iter->second;
+        }
+
+        VkDescriptorType get_descriptor_type(uint32_t storage_class, uint32_t type_id) const {
+            Type const &type = get_type(type_id);
+            if (storage_class == spv::storage_storage_buffer) {
+                return VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            }
+            if (storage_class == spv::storage_uniform) {
+                return get_decorations(type_id).buffer_block ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+            }
+            switch (type.op) {
+            case spv::op_type_sampler:
+                return VK_DESCRIPTOR_TYPE_SAMPLER;
+            case spv::op_type_sampled_image:
+                return VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+            case spv::op_type_acceleration_structure:
+                return VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+            case spv::op_type_image: {
+                // operands are sampled type, dim, depth, arrayed, multisampled, sampled
+                uint32_t dim = type.operands[1];
+                bool sampled = type.operands[5] == 1;
+                if (dim == spv::dim_subpass_data) {
+                    return VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                }
+                if (dim == spv::dim_buffer) {
+                    return sampled ? VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER;
+                }
+                return sampled ? VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE : VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+            }
+            }
+            raise_error("Unsupported SPIR-V resource type {}", type.op);
+        }
+
+        // explicit layout of the block members, the matrix stride is given by the enclosing struct
+        uint32_t get_size(uint32_t type_id, std::optional<uint32_t> matrix_stride) const {
+            Type const &type = get_type(type_id);
+            switch (type.op) {
+            case spv::op_type_bool:
+                return sizeof(uint32_t);
+            case spv::op_type_int:
+            case spv::op_type_float:
+                return type.operands[0] / 8;
+            case spv::op_type_vector:
+                return get_size(type.operands[0], std::nullopt) * type.operands[1];
+            case spv::op_type_matrix:
+                return matrix_stride.value_or(get_size(type.operands[0], std::nullopt)) * type.operands[1];
+            case spv::op_type_array: {
+                uint32_t length = get_constant(type.operands[1]);
+                auto stride = get_decorations(type_id).array_stride;
+                return length * stride.value_or(get_size(type.operands[0], matrix_stride));
+            }
+            case spv::op_type_struct: {
+                auto const &decorations = get_decorations(type_id);
+                uint32_t size = 0;
+                for (uint32_t member = 0; member < type.operands.size(); ++member) {
+                    auto offset = decorations.offsets.find(member);
+                    auto stride = decorations.matrix_strides.find(member);
+                    uint32_t member_size = get_size(type.operands[member],
+                                                    stride == decorations.matrix_strides.end() ? std::nullopt
+                                                                                               : std::optional{stride->second});
+                    size = std::max(size, (offset == decorations.offsets.end() ? size : offset->second) + member_size);
+                }
+                return size;
+            }
+            }
+            raise_error("Unsupported SPIR-V type {} in the block", type.op);
+        }
+
+        VkFormat get_format(uint32_t type_id) const {
+            Type const &type = get_type(type_id);
+            uint32_t components = 1;
+            uint32_t scalar_id = type_id;
+            if (type.op == spv::op_type_vector) {
+                components = type.operands[1];
+                scalar_id = type.operands[0];
+            }
+            Type const &scalar = get_type(scalar_id);
+            if ((scalar.op == spv::op_type_int || scalar.op == spv::op_type_float) && scalar.operands[0] == 32) {
+                if (scalar.op == spv::op_type_float) {
+                    VkFormat constexpr formats[] = {
+                        VK_FORMAT_R32_SFLOAT, VK_FORMAT_R32G32_SFLOAT, VK_FORMAT_R32G32B32_SFLOAT, VK_FORMAT_R32G32B32A32_SFLOAT};
+                    return formats[components - 1];
+                }
+                if (scalar.operands[1] == 1) {
+                    VkFormat constexpr formats[] = {
+                        VK_FORMAT_R32_SINT, VK_FORMAT_R32G32_SINT, VK_FORMAT_R32G32B32_SINT, VK_FORMAT_R32G32B32A32_SINT};
+                    return formats[components - 1];
+                }
+                VkFormat constexpr formats[] = {
+                    VK_FORMAT_R32_UINT, VK_FORMAT_R32G32_UINT, VK_FORMAT_R32G32B32_UINT, VK_FORMAT_R32G32B32A32_UINT};
+                return formats[components - 1];
+            }
+            raise_error("Unsupported SPIR-V vertex input type {}", type.op);
+        }
+    };
+
+} // namespace
+
+ShaderReflection::ShaderReflection(std::span<uint32_t const> code) {
+    ModuleParser parser{code};
+    stage_ = parser.get_stage();
+    entry_point_ = parser.get_entry_point();
+    bindings_ = parser.get_bindings();
+    push_constants_size_ = parser.get_push_constants_size();
+    inputs_ = parser.get_inputs();
+    local_size_ = parser.get_local_size();
+}
+
+ShaderLayout::ShaderLayout(std::initializer_list<ShaderReflection const *> reflections) {
+    VkShaderStageFlags push_constant_stages = 0;
+    uint32_t push_constants_size = 0;
+    for (ShaderReflection const *reflection : reflections) {
+        for (auto const &reflected : reflection->get_bindings()) {
+            if (reflected.set >= sets_.size()) {
+                sets_.resize(reflected.set + 1);
+            }
+            auto &bindings = sets_[reflected.set];
+            auto iter = std::lower_bound(bindings.begin(), bindings.end(), reflected.binding.binding, [](auto const &binding, uint32_t value) {
+                return binding.binding < value;
+            });
+            if (iter == bindings.end() || iter->binding != reflected.binding.binding) {
+                bindings.insert(iter, reflected.binding);
+                continue;
+            }
+            if (iter->descriptorType != reflected.binding.descriptorType || iter->descriptorCount != reflected.binding.descriptorCount) {
+                raise_error("Binding {} of set {} '{}' differs between the stages", reflected.binding.binding, reflected.set, reflected.name);
+            }
+            iter->stageFlags |= reflected.binding.stageFlags;
+        }
+        if (reflection->get_push_constants_size() > 0) {
+            push_constant_stages |= reflection->get_stage();
+            push_constants_size = std::max(push_constants_size, reflection->get_push_constants_size());
+        }
+        if (reflection->get_stage() == VK_SHADER_STAGE_VERTEX_BIT) {
+            for (auto const &input : reflection->get_inputs()) {
+                vertex_attributes_.push_back(VkVertexInputAttributeDescription{
+                    .location = input.location,
+                    .binding = 0,
+                    .format = input.format,
+                    .offset = vertex_stride_,
+                });
+                vertex_stride_ += input.size;
+            }
+        }
+    }
+    if (push_constants_size > 0) {
+        push_constant_ranges_.push_back(VkPushConstantRange{
+            .stageFlags = push_constant_stages,
+            .offset = 0,
+            .size = push_constants_size,
+        });
+    }
+}
@@ -0,0 +1,102 @@
+#pragma once
+
+#include "graphics_types.hpp"
+
+#include <array>
+#include <cstdint>
+#include <initializer_list>
+#include <span>
+#include <string>
+#include <vector>
+
+// resources of the shader module parsed from its SPIR-V words
+class ShaderReflection {
+  public:
+    struct Binding {
+        uint32_t set;
+        VkDescriptorSetLayoutBinding binding;
+        std::string name;
+    };
+
+    struct Input {
+        uint32_t location;
+        VkFormat format;
+        // size of the attribute in the vertex buffer
+        uint32_t size;
+        std::string name;
+    };
+
+  private:
+    VkShaderStageFlagBits stage_;
+    std::string entry_point_;
+    std::vector<Binding> bindings_;
+    // size of the push constant block, zero if there is none
+    uint32_t push_constants_size_ = 0;
+    std::vector<Input> inputs_;
+    std::array<uint32_t, 3> local_size_{1, 1, 1};
+
+  public:
+    explicit ShaderReflection(std::span<uint32_t const> code);
+
+    VkShaderStageFlagBits get_stage() const {
+        return stage_;
+    }
+
+    std::string const &get_entry_point() const {
+        return entry_point_;
+    }
+
+    // sorted by the set and the binding numbers
+    std::vector<Binding> const &get_bindings() const {
+        return bindings_;
+    }
+
+    uint32_t get_push_constants_size() const {
+        return push_constants_size_;
+    }
+
+    // inputs of the vertex stage sorted by the location, empty for the other stages
+    std::vector<Input> const &get_inputs() const {
+        return inputs_;
+    }
+
+    // workgroup size of the compute stage declared with literals
+    std::array<uint32_t, 3> const &get_local_size() const {
+        return local_size_;
+    }
+};
+
+// interface of the pipeline merged from the reflections of its stages
+class ShaderLayout {
+    std::vector<std::vector<VkDescriptorSetLayoutBinding>> sets_;
+    std::vector<VkPushConstantRange> push_constant_ranges_;
+    std::vector<VkVertexInputAttributeDescription> vertex_attributes_;
+    uint32_t vertex_stride_ = 0;
+
+  public:
+    // the bindings declared by several stages have to be of the same type
+    explicit ShaderLayout(std::initializer_list<ShaderReflection const *> reflections);
+
+    uint32_t get_sets_count() const {
+        return static_cast<uint32_t>(sets_.size());
+    }
+
+    // sorted by the binding number, empty for the unused sets
+    std::vector<VkDescriptorSetLayoutBinding> const &get_set_bindings(uint32_t set) const {
+        return sets_[set];
+    }
+
+    // the push constants of all the stages share a single range
+    std::vector<VkPushConstantRange> const &get_push_constant_ranges() const {
+        return push_constant_ranges_;
+    }
+
+    // the attributes are expected to be packed in the location order into the vertex buffer of binding 0
+    std::vector<VkVertexInputAttributeDescription> const &get_vertex_attributes() const {
+        return vertex_attributes_;
+    }
+
+    uint32_t get_vertex_stride() const {
+        return vertex_stride_;
+    }
+};
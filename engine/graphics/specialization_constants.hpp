@@ -0,0 +1,120 @@
+#pragma once
+
+#include "graphics_types.hpp"
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstring>
+#include <type_traits>
+#include <vector>
+
+// scalar types of the specialization constants, booleans are passed as VkBool32
+template <typename T>
+concept specialization_type = std::is_same_v<T, bool> || std::is_same_v<T, int32_t> || std::is_same_v<T, uint32_t> ||
+                              std::is_same_v<T, int64_t> || std::is_same_v<T, uint64_t> || std::is_same_v<T, float> ||
+                              std::is_same_v<T, double>;
+
+// value of the constant declared in the shader as layout(constant_id = id)
+template <uint32_t id, specialization_type T>
+struct SpecializationConstant {
+    static constexpr uint32_t constant_id = id;
+    using value_type = T;
+
+    T value;
+};
+
+// values of the specialization constants of a shader stage, the stages with different values are compiled separately
+class SpecializationConstants {
+    std::vector<VkSpecializationMapEntry> entries_;
+    std::vector<std::byte> data_;
+    VkSpecializationInfo info_{};
+
+    template <uint32_t... ids>
+    static constexpr bool are_unique() {
+        std::array<uint32_t, sizeof...(ids)> values{ids...};
+        for (size_t i = 0; i < values.size(); ++i) {
+            for (size_t j = i + 1; j < values.size(); ++j) {
+                if (values[i] == values[j]) {
+                    return false;
+                }
+            }
+        }
+        return true;
+    }
+
+    template <typename T>
+    void push(uint32_t constant_id, T value) {
+        using stored_t = std::conditional_t<std::is_same_v<T, bool>, VkBool32, T>;
+        stored_t stored = static_cast<stored_t>(value);
+        // values are aligned to their size so the data can be read in place
+        size_t offset = (data_.size() + sizeof(stored_t) - 1) / sizeof(stored_t) * sizeof(stored_t);
+        data_.resize(offset + sizeof(stored_t));
+        std::memcpy(data_.data() + offset, &stored, sizeof(stored_t));
+        entries_.push_back(VkSpecializationMapEntry{
+            .constantID = constant_id,
+            .offset = static_cast<uint32_t>(offset),
+            .size = sizeof(stored_t),
+        });
+    }
+
+    // the info points to the arrays of this object, not of the one it was copied from
+    void update_info() {
+        info_ = VkSpecializationInfo{
+            .mapEntryCount = static_cast<uint32_t>(entries_.size()),
+            .pMapEntries = entries_.data(),
+            .dataSize = data_.size(),
+            .pData = data_.data(),
+        };
+    }
+
+  public:
+    SpecializationConstants() = default;
+
+    // the identifiers are checked to be unique at compile time
+    template <uint32_t... ids, typename... Ts>
+    explicit SpecializationConstants(SpecializationConstant<ids, Ts>... constants) {
+        static_assert(are_unique<ids...>(), "Specialization constant identifiers must be unique.");
+        (push(ids, constants.value), ...);
+        update_info();
+    }
+
+    SpecializationConstants(SpecializationConstants const &other)
+        : entries_{other.entries_}
+        , data_{other.data_} {
+        update_info();
+    }
+
+    SpecializationConstants &operator=(SpecializationConstants const &other) {
+        if (this != &other) {
+            entries_ = other.entries_;
+            data_ = other.data_;
+            update_info();
+        }
+        return *this;
+    }
+
+    bool is_empty() const {
+        return entries_.empty();
+    }
+
+    // null if there are no constants so the shader defaults are used
+    VkSpecializationInfo const *get_info() const {
+        return entries_.empty() ? nullptr : &info_;
+    }
+
+    bool operator==(SpecializationConstants const &other) const {
+        return data_ == other.data_ && entries_.size() == other.entries_.size() &&
+               std::equal(entries_.begin(), entries_.end(), other.entries_.begin(), [](auto const &left, auto const &right) {
+                   return left.constantID == right.constantID && left.offset == right.offset && left.size == right.size;
+               });
+    }
+};
+
+// fixed set of the constants of a shader, every permutation of the shader is made by the same layout
+template <typename... Constants>
+struct SpecializationLayout {
+    static SpecializationConstants make(typename Constants::value_type... values) {
+        return SpecializationConstants{Constants{values}...};
+    }
+};
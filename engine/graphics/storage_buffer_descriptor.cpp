@@ -0,0 +1,43 @@
+#include "storage_buffer_descriptor.hpp"
+
+#include "graphics_error.hpp"
+
+StorageBufferDescriptor::StorageBufferDescriptor(uint32_t binding,
+                                                 VkShaderStageFlags stages,
+                                                 std::vector<VkDescriptorBufferInfo> &&buffer_infos)
+    : binding_{binding}
+    , stages_{stages}
+    , buffer_infos_{std::move(buffer_infos)} {
+    if (buffer_infos_.empty()) {
+        raise_error("Storage buffer descriptor of binding {} has no buffers.", binding_);
+    }
+}
+
+StorageBufferDescriptor::StorageBufferDescriptor(
+    uint32_t binding, VkShaderStageFlags stages, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range)
+    : StorageBufferDescriptor(binding, stages, {VkDescriptorBufferInfo{.buffer = buffer, .offset = offset, .range = range}}) {
+}
+
+VkDescriptorSetLayoutBinding StorageBufferDescriptor::get_binding() const {
+    return VkDescriptorSetLayoutBinding{
+        .binding = binding_,
+        .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .descriptorCount = 1,
+        .stageFlags = stages_,
+        .pImmutableSamplers = nullptr,
+    };
+}
+
+VkWriteDescriptorSet StorageBufferDescriptor::get_write(VkDescriptorSet descriptor_set, size_t image_index) const {
+    return VkWriteDescriptorSet{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = descriptor_set,
+        .dstBinding = binding_,
+        .dstArrayElement = 0,
+        .descriptorCount = 1,
+        .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER,
+        .pImageInfo = nullptr,
+        .pBufferInfo = &buffer_infos_[image_index % buffer_infos_.size()],
+        .pTexelBufferView = nullptr,
+    };
+}
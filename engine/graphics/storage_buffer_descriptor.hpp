@@ -0,0 +1,24 @@
+#pragma once
+
+#include "descriptor_interface.hpp"
+
+#include <vector>
+
+// buffer read and written by the shaders, e.g. by the compute ones
+class StorageBufferDescriptor : public DescriptorInterface {
+    uint32_t binding_;
+    VkShaderStageFlags stages_;
+    std::vector<VkDescriptorBufferInfo> buffer_infos_;
+
+  public:
+    // the images of the swapchain use the buffers in turn
+    StorageBufferDescriptor(uint32_t binding, VkShaderStageFlags stages, std::vector<VkDescriptorBufferInfo> &&buffer_infos);
+
+    // the buffer is shared by all the images
+    StorageBufferDescriptor(
+        uint32_t binding, VkShaderStageFlags stages, VkBuffer buffer, VkDeviceSize offset = 0, VkDeviceSize range = VK_WHOLE_SIZE);
+
+    VkDescriptorSetLayoutBinding get_binding() const override;
+
+    VkWriteDescriptorSet get_write(VkDescriptorSet descriptor_set, size_t image_index) const override;
+};
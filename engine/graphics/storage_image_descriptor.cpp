@@ -0,0 +1,47 @@
+#include "storage_image_descriptor.hpp"
+
+#include "graphics_error.hpp"
+
+StorageImageDescriptor::StorageImageDescriptor(uint32_t binding, VkShaderStageFlags stages, std::vector<VkImageView> const &image_views)
+    : binding_{binding}
+    , stages_{stages} {
+    if (image_views.empty()) {
+        raise_error("Storage image descriptor of binding {} has no images.", binding_);
+    }
+    image_infos_.reserve(image_views.size());
+    for (VkImageView image_view : image_views) {
+        image_infos_.push_back(VkDescriptorImageInfo{
+            .sampler = nullptr,
+            .imageView = image_view,
+            .imageLayout = VK_IMAGE_LAYOUT_GENERAL,
+        });
+    }
+}
+
+StorageImageDescriptor::StorageImageDescriptor(uint32_t binding, VkShaderStageFlags stages, VkImageView image_view)
+    : StorageImageDescriptor(binding, stages, std::vector<VkImageView>{image_view}) {
+}
+
+VkDescriptorSetLayoutBinding StorageImageDescriptor::get_binding() const {
+    return VkDescriptorSetLayoutBinding{
+        .binding = binding_,
+        .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+        .descriptorCount = 1,
+        .stageFlags = stages_,
+        .pImmutableSamplers = nullptr,
+    };
+}
+
+VkWriteDescriptorSet StorageImageDescriptor::get_write(VkDescriptorSet descriptor_set, size_t image_index) const {
+    return VkWriteDescriptorSet{
+        .sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET,
+        .dstSet = descriptor_set,
+        .dstBinding = binding_,
+        .dstArrayElement = 0,
+        .descriptorCount = 1,
+        .descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE,
+        .pImageInfo = &image_infos_[image_index % image_infos_.size()],
+        .pBufferInfo = nullptr,
+        .pTexelBufferView = nullptr,
+    };
+}
@@ -0,0 +1,22 @@
+#pragma once
+
+#include "descriptor_interface.hpp"
+
+#include <vector>
+
+// image loaded and stored by the shaders without a sampler, e.g. a mip level written by the compute shader
+class StorageImageDescriptor : public DescriptorInterface {
+    uint32_t binding_;
+    VkShaderStageFlags stages_;
+    std::vector<VkDescriptorImageInfo> image_infos_;
+
+  public:
+    // the images of the swapchain use the views in turn, the storage images have to be in the general layout
+    StorageImageDescriptor(uint32_t binding, VkShaderStageFlags stages, std::vector<VkImageView> const &image_views);
+
+    StorageImageDescriptor(uint32_t binding, VkShaderStageFlags stages, VkImageView image_view);
+
+    VkDescriptorSetLayoutBinding get_binding() const override;
+
+    VkWriteDescriptorSet get_write(VkDescriptorSet descriptor_set, size_t image_index) const override;
+};
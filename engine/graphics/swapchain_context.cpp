@@ -1,8 +1,8 @@
 #include "swapchain_context.hpp"
 
-#include "commander.hpp"
 #include "graphics_error.hpp"
 #include "graphics_manager.hpp"
+#include "pipeline_description.hpp"
 
 #include <array>
 
@@ -18,17 +18,6 @@ namespace {
 
 } // namespace
 
-SwapchainContext::IndexSequence::IndexSequence(size_t size)
-    : size_{size}
-    , index_{0} {
-}
-
-size_t SwapchainContext::IndexSequence::get_index() {
-    size_t index = index_;
-    index_ = (index_ + 1) % size_;
-    return index;
-}
-
 SwapchainContext::QfmContainer::QfmContainer(uint32_t graphics_qfm, uint32_t present_qfm)
     : size_{1} {
     array_[0] = graphics_qfm;
@@ -48,6 +37,7 @@ uint32_t SwapchainContext::QfmContainer::size() const {
 
 SwapchainContext::SwapchainContext(shared_ptr_of<VkDevice> device, std::shared_ptr<AllocatorInterface> allocator, Info const &info)
     : device_{device}
+    , allocator_{allocator}
     , command_pool_{GraphicsManager::make_command_pool(device,
                                                        VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT,
                                                        info.swapchain_info.graphics_qfm)}
@@ -82,7 +72,8 @@ SwapchainContext::SwapchainContext(shared_ptr_of<VkDevice> device, std::shared_p
         .stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE,
         .stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE,
         .initialLayout = VK_IMAGE_LAYOUT_UNDEFINED,
-        .finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
+        // offscreen images may be copied from after rendering
+        .finalLayout = is_offscreen() ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR,
     });
     color_attachments_.push_back(VkAttachmentReference{
         .attachment = 0,
@@ -95,7 +86,8 @@ SwapchainContext::SwapchainContext(shared_ptr_of<VkDevice> device, std::shared_p
     };
 
     if (info.depth_info.has_value()) {
-        depth_texture_ = std::make_unique<DepthTexture>(device, allocator, info.depth_info->depth_tiling, info.depth_info->depth_format);
+        depth_tiling_ = info.depth_info->depth_tiling;
+        depth_format_ = info.depth_info->depth_format;
         attachment_descriptions_.push_back(VkAttachmentDescription{
             .format = info.depth_info->depth_format,
             .samples = VK_SAMPLE_COUNT_1_BIT,
@@ -115,13 +107,15 @@ SwapchainContext::SwapchainContext(shared_ptr_of<VkDevice> device, std::shared_p
         .pColorAttachments = color_attachments_.data(),
         .pDepthStencilAttachment = info.depth_info.has_value() ? &depth_attachement_ : nullptr,
     };
+    // the depth texture is shared by all frames in flight so the previous frame must finish depth writes
     dependency_ = VkSubpassDependency{
         .srcSubpass = VK_SUBPASS_EXTERNAL,
         .dstSubpass = 0,
-        .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-        .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
-        .srcAccessMask = 0,
-        .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT,
+        .srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT,
+        .dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT,
+        .srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
+        .dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT |
+                         VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT,
     };
     render_pass_info_ = VkRenderPassCreateInfo{
         .sType = VK_STRUCTURE_TYPE_RENDER_PASS_CREATE_INFO,
@@ -132,59 +126,91 @@ SwapchainContext::SwapchainContext(shared_ptr_of<VkDevice> device, std::shared_p
         .dependencyCount = 1,
         .pDependencies = &dependency_,
     };
+    render_pass_key_ = get_render_pass_compatibility_key(render_pass_info_);
 }
 
 SwapchainContext::~SwapchainContext() = default;
 
-ImageContext const &SwapchainContext::get_image() {
-    return image_contexts_[index_sequence_.get_index()];
-}
-
-void SwapchainContext::update_extent(VkExtent2D extent, VkQueue graphics_queue) {
+void SwapchainContext::update_extent(VkExtent2D extent, DeferredDeleter &deleter) {
+    // resources of the previous swapchain may be still used by the frames in flight
     std::vector<VkImageView> image_views(1);
-    if (depth_texture_) {
-        Commander transition_commander{device_, command_pool_, graphics_queue};
-        depth_texture_->update_extent(extent, transition_commander);
+    if (depth_format_ != VK_FORMAT_UNDEFINED) {
+        deleter.retire(std::move(depth_texture_));
+        depth_texture_ = std::make_unique<DepthTexture>(device_, allocator_, depth_tiling_, depth_format_);
+        depth_texture_->update_extent(extent);
         image_views.resize(2);
         image_views[1] = depth_texture_->get_image_view();
     }
 
     swapchain_info_.imageExtent = extent;
-    swapchain_info_.oldSwapchain = swapchain_.get();
-    swapchain_ = GraphicsManager::make_swapchain(device_, swapchain_info_);
-    render_pass_ = GraphicsManager::make_render_pass(device_, render_pass_info_);
-
-    auto images = get_swapchain_images(device_.get(), swapchain_.get());
-    size_t prev_size = image_contexts_.size();
-    image_contexts_.resize(images.size());
-    // fill new images
-    for (size_t i = 0; i < image_contexts_.size(); ++i) {
-        ImageContext &image_context = image_contexts_[i];
-        image_context.set_image_view(
-            GraphicsManager::make_image_view(device_, images[i], swapchain_info_.imageFormat, VK_IMAGE_ASPECT_COLOR_BIT));
+    std::vector<ImageContext> image_contexts;
+    if (is_offscreen()) {
+        image_contexts.resize(swapchain_info_.minImageCount);
+        for (auto &image_context : image_contexts) {
+            image_context.set_offscreen_texture(std::make_unique<OffscreenTexture>(
+                device_, allocator_, swapchain_info_.imageFormat, swapchain_info_.imageUsage, extent));
+        }
+    } else {
+        swapchain_info_.oldSwapchain = swapchain_.get();
+        auto swapchain = GraphicsManager::make_swapchain(device_, swapchain_info_);
+        // the frame fences do not cover the presents which are still pending on the images of the old swapchain
+        if (swapchain_) {
+            retired_swapchains_.push_back(RetiredSwapchain{
+                .swapchain = std::move(swapchain_),
+                .present_semaphores = std::move(present_semaphores_),
+            });
+        }
+        swapchain_ = std::move(swapchain);
+        auto images = get_swapchain_images(device_.get(), swapchain_.get());
+        image_contexts.resize(images.size());
+        for (size_t i = 0; i < image_contexts.size(); ++i) {
+            image_contexts[i].set_image(images[i]);
+        }
+        std::vector<unique_ptr_of<VkSemaphore>> present_semaphores(images.size());
+        for (auto &present_semaphore : present_semaphores) {
+            present_semaphore = GraphicsManager::make_semaphore(device_);
+        }
+        present_semaphores_ = std::move(present_semaphores);
+    }
+    // render pass does not depend on the extent
+    if (!render_pass_) {
+        render_pass_ = GraphicsManager::make_render_pass(device_, render_pass_info_);
+    }
+
+    for (auto &image_context : image_contexts) {
+        image_context.set_image_view(GraphicsManager::make_image_view(
+            device_, image_context.get_image(), swapchain_info_.imageFormat, VK_IMAGE_ASPECT_COLOR_BIT));
         image_views[0] = image_context.get_image_view();
         image_context.set_framebuffer(
             GraphicsManager::make_framebuffer(device_, image_views, render_pass_.get(), swapchain_info_.imageFormat, extent));
-    }
-    // fill only for new count of images
-    for (size_t i = prev_size; i < image_contexts_.size(); ++i) {
-        ImageContext &image_context = image_contexts_[i];
         image_context.set_command_buffer(GraphicsManager::make_command_buffer(device_, command_pool_));
-        image_context.set_submit_semaphore(GraphicsManager::make_semaphore(device_));
-        image_context.set_present_semaphore(GraphicsManager::make_semaphore(device_));
     }
-    index_sequence_ = IndexSequence(image_contexts_.size());
+    deleter.retire(std::move(image_contexts_));
+    image_contexts_ = std::move(image_contexts);
+}
+
+void SwapchainContext::release_retired_swapchains() {
+    retired_swapchains_.clear();
+}
+
+void SwapchainContext::retire_swapchains(DeferredDeleter &deleter) {
+    for (auto &retired_swapchain : retired_swapchains_) {
+        deleter.retire(std::move(retired_swapchain));
+    }
+    retired_swapchains_.clear();
 }
 
 std::vector<ImageRenderer> SwapchainContext::get_image_renderers() const {
     std::vector<ImageRenderer> image_renderers;
     image_renderers.reserve(image_contexts_.size());
-    for (auto const &image : image_contexts_) {
-        image_renderers.emplace_back(image.get_command_buffer(),
-                                     image.get_framebuffer(),
-                                     render_pass_.get(),
-                                     swapchain_info_.imageExtent,
-                                     std::span(clear_values_));
+    for (uint32_t image_index = 0; image_index < image_contexts_.size(); ++image_index) {
+        image_renderers.push_back(get_image_renderer(image_index));
     }
     return image_renderers;
 }
+
+ImageRenderer SwapchainContext::get_image_renderer(uint32_t image_index) const {
+    auto const &image = image_contexts_[image_index];
+    return ImageRenderer(
+        image.get_command_buffer(), image.get_framebuffer(), render_pass_.get(), swapchain_info_.imageExtent, std::span(clear_values_));
+}
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "allocator_interface.hpp"
+#include "deferred_deleter.hpp"
 #include "depth_texture.hpp"
 #include "image_context.hpp"
 #include "image_renderer.hpp"
@@ -9,14 +10,10 @@
 #include <vector>
 
 class SwapchainContext {
-    class IndexSequence {
-        size_t size_;
-        size_t index_;
-
-      public:
-        IndexSequence(size_t size = 0);
-
-        size_t get_index();
+    // the presents may still wait for the semaphores of the old swapchain when its frames have been completed
+    struct RetiredSwapchain {
+        unique_ptr_of<VkSwapchainKHR> swapchain;
+        std::vector<unique_ptr_of<VkSemaphore>> present_semaphores;
     };
 
     class QfmContainer {
@@ -32,12 +29,14 @@ class SwapchainContext {
     };
 
     shared_ptr_of<VkDevice> device_;
+    std::shared_ptr<AllocatorInterface> allocator_;
     shared_ptr_of<VkCommandPool> command_pool_;
     unique_ptr_of<VkSwapchainKHR> swapchain_;
     unique_ptr_of<VkRenderPass> render_pass_;
     QfmContainer qfm_indices_;
     std::unique_ptr<DepthTexture> depth_texture_;
-    IndexSequence index_sequence_;
+    VkImageTiling depth_tiling_ = VK_IMAGE_TILING_OPTIMAL;
+    VkFormat depth_format_ = VK_FORMAT_UNDEFINED;
     VkSwapchainCreateInfoKHR swapchain_info_;
     VkAttachmentDescription color_attachment_;
     std::vector<VkAttachmentDescription> attachment_descriptions_;
@@ -47,7 +46,12 @@ class SwapchainContext {
     VkSubpassDescription subpass_;
     VkSubpassDependency dependency_;
     VkRenderPassCreateInfo render_pass_info_;
+    uint64_t render_pass_key_;
     std::vector<ImageContext> image_contexts_;
+    // the presentation of the image waits for its semaphore, the semaphore is signaled again only after the image is
+    // acquired again which implies the previous presentation has waited for it
+    std::vector<unique_ptr_of<VkSemaphore>> present_semaphores_;
+    std::vector<RetiredSwapchain> retired_swapchains_;
 
   public:
     struct Info {
@@ -74,21 +78,49 @@ class SwapchainContext {
 
     ~SwapchainContext();
 
-    ImageContext const &get_image();
+    ImageContext const &get_image(uint32_t image_index) const {
+        return image_contexts_[image_index];
+    }
+
+    VkSemaphore get_present_semaphore(uint32_t image_index) const {
+        return present_semaphores_[image_index].get();
+    }
 
     VkSwapchainKHR get_swapchain() const {
         return swapchain_.get();
     }
 
+    // images are rendered offscreen and never presented when there is no surface
+    bool is_offscreen() const {
+        return swapchain_info_.surface == nullptr;
+    }
+
     VkRenderPass get_render_pass() const {
         return render_pass_.get();
     }
 
+    uint64_t get_render_pass_key() const {
+        return render_pass_key_;
+    }
+
     uint32_t get_images_count() const {
         return static_cast<uint32_t>(image_contexts_.size());
     }
 
-    void update_extent(VkExtent2D extent, VkQueue graphics_queue);
+    // the old swapchain is passed to the new one and retired until its presents are complete
+    void update_extent(VkExtent2D extent, DeferredDeleter &deleter);
+
+    bool has_retired_swapchains() const {
+        return !retired_swapchains_.empty();
+    }
+
+    // must be called when the presents of the old swapchains are known to be complete, e.g. the present queue is idle
+    void release_retired_swapchains();
+
+    // the old swapchains are destroyed with the frames submitted before, the frames must be completed after their presents
+    void retire_swapchains(DeferredDeleter &deleter);
 
     std::vector<ImageRenderer> get_image_renderers() const;
+
+    ImageRenderer get_image_renderer(uint32_t image_index) const;
 };
\ No newline at end of file
@@ -3,52 +3,190 @@
 #include "graphics_error.hpp"
 #include "graphics_manager.hpp"
 
+#include "utility/trace.hpp"
+
+#include <algorithm>
+
 namespace {
 
     uint64_t constexpr timeout = std::numeric_limits<uint64_t>::max();
+    // presentation may never complete for a hidden window so the wait is bounded
+    uint64_t constexpr present_timeout = 100'000'000;
 
 }
 
-SwapchainPresenter::SwapchainPresenter(shared_ptr_of<VkDevice> device, VkQueue graphics_queue, VkQueue present_queue)
+SwapchainPresenter::SwapchainPresenter(shared_ptr_of<VkDevice> device,
+                                       VkQueue graphics_queue,
+                                       VkQueue present_queue,
+                                       uint32_t frames_count,
+                                       bool present_wait,
+                                       bool present_fence)
     : device_{device}
-    , sync_fence_{GraphicsManager::make_fence(device)}
     , graphics_queue_{graphics_queue}
     , present_queue_{present_queue} {
+    frames_.resize(std::clamp(frames_count, 1u, max_frames_count));
+    for (auto &frame : frames_) {
+        frame.sync_fence = GraphicsManager::make_fence(device);
+        if (present_fence) {
+            frame.present_fence = GraphicsManager::make_fence(device);
+        }
+        frame.submit_semaphore = GraphicsManager::make_semaphore(device);
+    }
+    info_println("Use {} frames in flight", frames_.size());
+    if (present_wait) {
+        wait_for_present_ = reinterpret_cast<PFN_vkWaitForPresentKHR>(vkGetDeviceProcAddr(device.get(), "vkWaitForPresentKHR"));
+    }
+}
+
+void SwapchainPresenter::wait_present_fences() const {
+    std::vector<VkFence> fences;
+    for (auto const &frame : frames_) {
+        if (frame.present_fence != nullptr) {
+            fences.push_back(frame.present_fence.get());
+        }
+    }
+    if (!fences.empty()) {
+        vk_assert(vkWaitForFences(device_.get(), static_cast<uint32_t>(fences.size()), fences.data(), VK_TRUE, timeout),
+                  "Failed to wait for the present fences.");
+    }
 }
 
-void SwapchainPresenter::submit_and_present(VkSwapchainKHR swapchain, ImageContext const &image_context) {
+void SwapchainPresenter::add_wait_semaphore(VkSemaphore semaphore, uint64_t value, VkPipelineStageFlags stage) {
+    auto iter = std::find(wait_semaphores_.begin(), wait_semaphores_.end(), semaphore);
+    if (iter == wait_semaphores_.end()) {
+        wait_semaphores_.push_back(semaphore);
+        wait_values_.push_back(value);
+        wait_stages_.push_back(stage);
+        return;
+    }
+    // the greater value of the timeline semaphore implies the lesser ones
+    size_t index = static_cast<size_t>(iter - wait_semaphores_.begin());
+    wait_values_[index] = std::max(wait_values_[index], value);
+    wait_stages_[index] |= stage;
+}
+
+bool SwapchainPresenter::submit_and_present(SwapchainContext const &swapchain_context) {
+    trace_zone("submit_and_present");
     constexpr uint32_t count = 1;
+    // acquire semaphore and fence belong to the frame slot while the present semaphore belongs to the image
+    FrameContext &frame = frames_[frame_index_];
+    VkSwapchainKHR swapchain = swapchain_context.get_swapchain();
     VkPipelineStageFlags stage_flags = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
-    VkSemaphore submit_semaphore = image_context.get_submit_semaphore();
-    VkSemaphore present_semaphore = image_context.get_present_semaphore();
-    VkCommandBuffer command_buffer = image_context.get_command_buffer();
-    VkFence sync_fence = sync_fence_.get();
+    VkSemaphore submit_semaphore = frame.submit_semaphore.get();
+    VkFence sync_fence = frame.sync_fence.get();
 
-    vk_assert(vkWaitForFences(device_.get(), 1, &sync_fence, VK_TRUE, timeout), "Failed to wait for fences.");
-    vk_assert(vkResetFences(device_.get(), 1, &sync_fence), "Failed to reset the fences.");
+    {
+        trace_zone("wait_frame_fence");
+        vk_assert(vkWaitForFences(device_.get(), 1, &sync_fence, VK_TRUE, timeout), "Failed to wait for fences.");
+    }
+    VkFence present_fence = frame.present_fence.get();
+    if (present_fence != nullptr) {
+        trace_zone("wait_present_fence");
+        vk_assert(vkWaitForFences(device_.get(), 1, &present_fence, VK_TRUE, timeout), "Failed to wait for the present fence.");
+    }
+    completed_frame_ = std::max(completed_frame_, frame.frame_number);
 
     uint32_t image_index;
-    vk_assert(vkAcquireNextImageKHR(device_.get(), swapchain, timeout, submit_semaphore, nullptr, &image_index),
-              "Failed to acquire next image.");
+    bool suboptimal = false;
+    if (swapchain_context.is_offscreen()) {
+        // offscreen images are used in turn and never presented
+        image_index = offscreen_index_++ % swapchain_context.get_images_count();
+    } else {
+        trace_zone("acquire_image");
+        VkResult result = vkAcquireNextImageKHR(device_.get(), swapchain, timeout, submit_semaphore, nullptr, &image_index);
+        if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+            // the fence is not reset and the semaphore is not signaled so the frame slot can be reused
+            return false;
+        }
+        // suboptimal image is acquired and has to be presented
+        suboptimal = result == VK_SUBOPTIMAL_KHR;
+        if (!suboptimal) {
+            vk_assert(result, "Failed to acquire next image.");
+        }
+    }
+
+    // images may be returned out of order so wait for the frame which has been rendering into the image last time
+    if (image_index >= image_fences_.size()) {
+        image_fences_.resize(image_index + 1, nullptr);
+    }
+    if (image_fences_[image_index] != nullptr && image_fences_[image_index] != sync_fence) {
+        trace_zone("wait_image_fence");
+        vk_assert(vkWaitForFences(device_.get(), 1, &image_fences_[image_index], VK_TRUE, timeout), "Failed to wait for image fence.");
+    }
+    image_fences_[image_index] = sync_fence;
+    // command buffer and framebuffer belong to the image returned by the presentation engine
+    VkCommandBuffer command_buffer = swapchain_context.get_image(image_index).get_command_buffer();
+    VkSemaphore present_semaphore = swapchain_context.is_offscreen() ? nullptr : swapchain_context.get_present_semaphore(image_index);
 
     if (frame_callback_) {
-        frame_callback_(image_index);
+        trace_zone("update_frame");
+        frame_callback_(frame_index_, image_index);
     }
 
+    vk_assert(vkResetFences(device_.get(), 1, &sync_fence), "Failed to reset the fences.");
+
+    // offscreen frames neither wait for an acquired image nor signal the presentation
+    uint32_t semaphores_count = swapchain_context.is_offscreen() ? 0 : count;
+    if (semaphores_count > 0) {
+        // the value of the binary semaphore is ignored
+        wait_semaphores_.insert(wait_semaphores_.begin(), submit_semaphore);
+        wait_values_.insert(wait_values_.begin(), 0);
+        wait_stages_.insert(wait_stages_.begin(), stage_flags);
+    }
+    VkTimelineSemaphoreSubmitInfo timeline_info{
+        .sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO,
+        .waitSemaphoreValueCount = static_cast<uint32_t>(wait_values_.size()),
+        .pWaitSemaphoreValues = wait_values_.data(),
+    };
+    bool timeline_waits = wait_semaphores_.size() > semaphores_count;
     VkSubmitInfo submit_info{
         .sType = VK_STRUCTURE_TYPE_SUBMIT_INFO,
-        .waitSemaphoreCount = count,
-        .pWaitSemaphores = &submit_semaphore,
-        .pWaitDstStageMask = &stage_flags,
+        .pNext = timeline_waits ? &timeline_info : nullptr,
+        .waitSemaphoreCount = static_cast<uint32_t>(wait_semaphores_.size()),
+        .pWaitSemaphores = wait_semaphores_.data(),
+        .pWaitDstStageMask = wait_stages_.data(),
         .commandBufferCount = count,
         .pCommandBuffers = &command_buffer,
-        .signalSemaphoreCount = count,
+        .signalSemaphoreCount = semaphores_count,
         .pSignalSemaphores = &present_semaphore,
     };
-    vk_assert(vkQueueSubmit(graphics_queue_, 1, &submit_info, sync_fence), "Failed to submit the queue.");
+    {
+        trace_zone("queue_submit");
+        vk_assert(vkQueueSubmit(graphics_queue_, 1, &submit_info, sync_fence), "Failed to submit the queue.");
+    }
+    wait_semaphores_.clear();
+    wait_values_.clear();
+    wait_stages_.clear();
+    frame.frame_number = ++submitted_frame_;
+    if (swapchain_context.is_offscreen()) {
+        frame_index_ = (frame_index_ + 1) % frames_.size();
+        return true;
+    }
 
+    if (swapchain != present_swapchain_) {
+        present_swapchain_ = swapchain;
+        swapchain_present_id_ = present_id_;
+    }
+    uint64_t present_id = ++present_id_;
+    VkPresentIdKHR present_id_info{
+        .sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR,
+        .swapchainCount = count,
+        .pPresentIds = &present_id,
+    };
+    VkSwapchainPresentFenceInfoEXT present_fence_info{
+        .sType = VK_STRUCTURE_TYPE_SWAPCHAIN_PRESENT_FENCE_INFO_EXT,
+        .pNext = wait_for_present_ ? &present_id_info : nullptr,
+        .swapchainCount = count,
+        .pFences = &present_fence,
+    };
+    if (present_fence != nullptr) {
+        vk_assert(vkResetFences(device_.get(), 1, &present_fence), "Failed to reset the present fence.");
+    }
     VkPresentInfoKHR present_info{
         .sType = VK_STRUCTURE_TYPE_PRESENT_INFO_KHR,
+        .pNext = present_fence != nullptr ? static_cast<void const *>(&present_fence_info)
+                 : wait_for_present_      ? static_cast<void const *>(&present_id_info)
+                                          : nullptr,
         .waitSemaphoreCount = count,
         .pWaitSemaphores = &present_semaphore,
         .swapchainCount = count,
@@ -56,5 +194,33 @@ void SwapchainPresenter::submit_and_present(VkSwapchainKHR swapchain, ImageConte
         .pImageIndices = &image_index,
         .pResults = nullptr,
     };
-    vk_assert(vkQueuePresentKHR(present_queue_, &present_info), "Failed to present the queue.");
+    VkResult result;
+    {
+        trace_zone("queue_present");
+        result = vkQueuePresentKHR(present_queue_, &present_info);
+    }
+    frame_index_ = (frame_index_ + 1) % frames_.size();
+    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+        return false;
+    }
+    vk_assert(result, "Failed to present the queue.");
+    return !suboptimal;
+}
+
+uint64_t SwapchainPresenter::wait_queued_presents(SwapchainContext const &swapchain_context, uint32_t queued_count) {
+    // identifiers presented to the previous swapchains can not be waited for
+    if (wait_for_present_ == nullptr || swapchain_context.get_swapchain() != present_swapchain_ ||
+        present_id_ <= swapchain_present_id_ + queued_count) {
+        return 0;
+    }
+    uint64_t present_id = present_id_ - queued_count;
+    VkResult result = wait_for_present_(device_.get(), present_swapchain_, present_id, present_timeout);
+    if (result == VK_TIMEOUT || result == VK_ERROR_OUT_OF_DATE_KHR) {
+        // the outdated swapchain is recreated on the next present
+        return 0;
+    }
+    if (result != VK_SUBOPTIMAL_KHR) {
+        vk_assert(result, "Failed to wait for the present {}.", present_id);
+    }
+    return present_id;
 }
@@ -2,25 +2,92 @@
 
 #include "graphics_types.hpp"
 
-#include "image_context.hpp"
+#include "swapchain_context.hpp"
+
+#include <vector>
 
 class SwapchainPresenter {
   public:
-    using update_frame_t = std::function<void(size_t frame_index)>;
+    using update_frame_t = std::function<void(size_t frame_index, size_t image_index)>;
+
+    static constexpr uint32_t max_frames_count = 3;
 
   private:
+    struct FrameContext {
+        unique_ptr_of<VkFence> sync_fence;
+        // signaled when the present of the frame has done with its semaphore, the frame is completed only after that
+        unique_ptr_of<VkFence> present_fence;
+        unique_ptr_of<VkSemaphore> submit_semaphore;
+        uint64_t frame_number = 0;
+    };
+
     shared_ptr_of<VkDevice> device_;
-    unique_ptr_of<VkFence> sync_fence_;
+    std::vector<FrameContext> frames_;
+    // fence of the frame which has been rendering into the image last time
+    std::vector<VkFence> image_fences_;
+    size_t frame_index_ = 0;
+    uint32_t offscreen_index_ = 0;
+    uint64_t submitted_frame_ = 0;
+    uint64_t completed_frame_ = 0;
     VkQueue graphics_queue_;
     VkQueue present_queue_;
     update_frame_t frame_callback_;
+    // present identifiers increase monotonically across swapchains
+    uint64_t present_id_ = 0;
+    uint64_t swapchain_present_id_ = 0;
+    VkSwapchainKHR present_swapchain_ = nullptr;
+    PFN_vkWaitForPresentKHR wait_for_present_ = nullptr;
+    // timeline semaphores the next submit waits for besides the acquired image
+    std::vector<VkSemaphore> wait_semaphores_;
+    std::vector<uint64_t> wait_values_;
+    std::vector<VkPipelineStageFlags> wait_stages_;
 
   public:
-    SwapchainPresenter(shared_ptr_of<VkDevice> device, VkQueue graphics_queue, VkQueue present_queue);
+    SwapchainPresenter(shared_ptr_of<VkDevice> device,
+                       VkQueue graphics_queue,
+                       VkQueue present_queue,
+                       uint32_t frames_count,
+                       bool present_wait,
+                       bool present_fence);
+
+    // returns false if the swapchain is out of date or suboptimal and has to be recreated
+    bool submit_and_present(SwapchainContext const &swapchain_context);
+
+    // the idle device does not imply the completed presents, waited before the old swapchains are destroyed
+    void wait_present_fences() const;
+
+    // the next submitted frame waits at the stage until the timeline semaphore reaches the value
+    void add_wait_semaphore(VkSemaphore semaphore, uint64_t value, VkPipelineStageFlags stage);
+
+    // blocks until no more than queued_count presents are pending, returns the identifier of the presented image or 0
+    uint64_t wait_queued_presents(SwapchainContext const &swapchain_context, uint32_t queued_count);
+
+    bool is_present_wait_enabled() const {
+        return wait_for_present_ != nullptr;
+    }
 
-    void submit_and_present(VkSwapchainKHR swapchain, ImageContext const &image_context);
+    // the completed frames imply the completed presents so the old swapchains can be retired with the frames
+    bool is_present_fence_enabled() const {
+        return !frames_.empty() && frames_.front().present_fence != nullptr;
+    }
+
+    uint64_t get_present_id() const {
+        return present_id_;
+    }
+
+    uint64_t get_submitted_frame() const {
+        return submitted_frame_;
+    }
+
+    uint64_t get_completed_frame() const {
+        return completed_frame_;
+    }
+
+    uint32_t get_frames_count() const {
+        return static_cast<uint32_t>(frames_.size());
+    }
 
     void set_update_frame_callback(update_frame_t const &callback) {
         frame_callback_ = callback;
     }
-};
\ No newline at end of file
+};
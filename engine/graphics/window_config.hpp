@@ -99,4 +99,8 @@ struct WindowConfig {
     char const *title;
     int width;
     int height;
+    // no window is created, the size defines the extent of the rendered images
+    bool headless = false;
+    // headless rendering presents to VK_EXT_headless_surface when supported, otherwise to offscreen images
+    bool headless_surface = true;
 };
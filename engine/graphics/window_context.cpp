@@ -2,6 +2,8 @@
 
 #include "graphics_error.hpp"
 
+#include <type_traits>
+
 namespace {
 
     class glfwinstance {
@@ -18,39 +20,48 @@ namespace {
         }
     };
 
-    glfwinstance instance;
+    // glfw is initialized only for the windows so the headless mode does not require a display
+    void init_glfw() {
+        static glfwinstance instance;
+    }
 
     std::unordered_map<GLFWwindow *, WindowContext> map;
 
     void resize_callback(GLFWwindow *window, int width, int height) {
         if (auto window_ctx = WindowContext::get_window_context(window)) {
-            window_ctx->execute_resize_callback(width, height);
+            window_ctx->handle_event(ResizeEvent{.width = width, .height = height});
         }
     }
 
     void keyboard_callback(GLFWwindow *window, int key, int /* scancode */, int action, int mods) {
         if (auto window_ctx = WindowContext::get_window_context(window)) {
-            window_ctx->execute_keyboard_callback(static_cast<key_value>(key), static_cast<key_action>(action), static_cast<key_modifier>(mods));
+            window_ctx->handle_event(KeyboardEvent{
+                .value = static_cast<key_value>(key),
+                .action = static_cast<key_action>(action),
+                .modifier = static_cast<key_modifier>(mods),
+            });
         }
     }
 
     void mouse_button_callback(GLFWwindow *window, int button, int action, int mods) {
         if (auto window_ctx = WindowContext::get_window_context(window)) {
-            window_ctx->execute_mouse_button_callback(static_cast<mouse_button>(button),
-                                               static_cast<key_action>(action),
-                                               static_cast<key_modifier>(mods));
+            window_ctx->handle_event(MouseButtonEvent{
+                .button = static_cast<mouse_button>(button),
+                .action = static_cast<key_action>(action),
+                .modifier = static_cast<key_modifier>(mods),
+            });
         }
     }
 
     void mouse_scroll_callback(GLFWwindow *window, double /* xoffset */, double yoffset) {
         if (auto window_ctx = WindowContext::get_window_context(window)) {
-            window_ctx->execute_mouse_scroll_callback(yoffset);
+            window_ctx->handle_event(MouseScrollEvent{.offset = yoffset});
         }
     }
 
     void cursor_callback(GLFWwindow *window, double x, double y) {
         if (auto window_ctx = WindowContext::get_window_context(window)) {
-            window_ctx->execute_cursor_callback(x, y);
+            window_ctx->handle_event(CursorEvent{.x = x, .y = y});
         }
     }
 
@@ -61,12 +72,17 @@ namespace {
 
 } // namespace
 
+void WindowContext::init() {
+    init_glfw();
+}
+
 unique_ptr_of<GLFWwindow *> WindowContext::make_window(WindowConfig const &info) {
+    init_glfw();
     auto window = glfwCreateWindow(info.width, info.height, info.title, nullptr, nullptr);
     if (window == nullptr) {
         raise_error("Failed to create a GLFW window.")
     }
-    glfwSetWindowSizeCallback(window, &resize_callback);
+    glfwSetFramebufferSizeCallback(window, &resize_callback);
     glfwSetKeyCallback(window, &keyboard_callback);
     glfwSetMouseButtonCallback(window, &mouse_button_callback);
     glfwSetScrollCallback(window, &mouse_scroll_callback);
@@ -79,6 +95,73 @@ unique_ptr_of<GLFWwindow *> WindowContext::make_window(WindowConfig const &info)
     return unique_ptr_of<GLFWwindow *>(window, &delete_window);
 }
 
+void WindowContext::handle_event(WindowEvent const &event) {
+    if (!event_channel_->deferred.load(std::memory_order_acquire)) {
+        execute_callback(event);
+        return;
+    }
+    if (!event_channel_->queue.push(event)) {
+        // the render thread is stalled, blocking here would stall the event polling too
+        debug_println("Window event queue is full, the event is dropped");
+        return;
+    }
+    post_empty_event();
+}
+
+void WindowContext::execute_callback(WindowEvent const &event) {
+    std::visit(
+        [this](auto const &e) {
+            using event_t = std::decay_t<decltype(e)>;
+            if constexpr (std::is_same_v<event_t, ResizeEvent>) {
+                execute_resize_callback(e.width, e.height);
+            } else if constexpr (std::is_same_v<event_t, CursorEvent>) {
+                execute_cursor_callback(e.x, e.y);
+            } else if constexpr (std::is_same_v<event_t, KeyboardEvent>) {
+                execute_keyboard_callback(e.value, e.action, e.modifier);
+            } else if constexpr (std::is_same_v<event_t, MouseButtonEvent>) {
+                execute_mouse_button_callback(e.button, e.action, e.modifier);
+            } else if constexpr (std::is_same_v<event_t, MouseScrollEvent>) {
+                execute_mouse_scroll_callback(e.offset);
+            }
+        },
+        event);
+}
+
+void WindowContext::set_deferred_events(bool deferred) {
+    if (deferred) {
+        // the wakeups posted before the render thread has started are not pending events
+        event_channel_->dispatched = event_channel_->posted.load(std::memory_order_acquire);
+        event_channel_->deferred.store(true, std::memory_order_release);
+        return;
+    }
+    // deliver events queued before the render thread has stopped
+    dispatch_events();
+    event_channel_->deferred.store(false, std::memory_order_release);
+}
+
+void WindowContext::dispatch_events() {
+    if (!event_channel_->deferred.load(std::memory_order_acquire)) {
+        return;
+    }
+    event_channel_->dispatched = event_channel_->posted.load(std::memory_order_acquire);
+    WindowEvent event;
+    while (event_channel_->queue.pop(event)) {
+        execute_callback(event);
+    }
+}
+
+void WindowContext::wait_events() {
+    if (event_channel_->deferred.load(std::memory_order_acquire)) {
+        event_channel_->posted.wait(event_channel_->dispatched, std::memory_order_acquire);
+    }
+}
+
+void WindowContext::post_empty_event() {
+    // the channel is never reset so it's safe to post from any thread in any mode
+    event_channel_->posted.fetch_add(1, std::memory_order_release);
+    event_channel_->posted.notify_one();
+}
+
 WindowContext *WindowContext::WindowContext::get_window_context(GLFWwindow *window) {
     auto iter = map.find(window);
     if (iter == map.end()) {
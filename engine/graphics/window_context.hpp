@@ -2,15 +2,29 @@
 
 #include "graphics_types.hpp"
 #include "window_config.hpp"
+#include "window_event.hpp"
+
+#include "utility/spsc_queue.hpp"
 
 #include <GLFW/glfw3.h>
 
 class WindowContext {
+    // events are passed from the main thread which polls them to the render thread
+    struct EventChannel {
+        SpscQueue<WindowEvent, 4096> queue;
+        std::atomic<uint64_t> posted{0};
+        uint64_t dispatched = 0;
+        // switched by the main thread while the other threads may post to the channel
+        std::atomic_bool deferred{false};
+    };
+
     WindowConfig::resize_t resize_callback_;
     WindowConfig::cursor_t cursor_callback_;
     WindowConfig::keyboard_t keyboard_callback_;
     WindowConfig::mouse_button_t mouse_button_callback_;
     WindowConfig::mouse_scroll_t mouse_scroll_callback_;
+    // lives as long as the window so the threads posting to it never see it replaced
+    std::unique_ptr<EventChannel> event_channel_ = std::make_unique<EventChannel>();
 
   public:
     void set_resize_callback(WindowConfig::resize_t const &callback) {
@@ -63,6 +77,24 @@ class WindowContext {
         }
     }
 
+    // executes the callback immediately or queues the event when events are deferred
+    void handle_event(WindowEvent const &event);
+
+    void execute_callback(WindowEvent const &event);
+
+    void set_deferred_events(bool deferred);
+
+    // executes callbacks of all the queued events, must be called from the consumer thread only
+    void dispatch_events();
+
+    // blocks the consumer thread until a new event is queued or posted
+    void wait_events();
+
+    void post_empty_event();
+
+    // initializes glfw once, required before the instance extensions of the windows are queried
+    static void init();
+
     static unique_ptr_of<GLFWwindow *> make_window(WindowConfig const &info);
 
     static WindowContext *get_window_context(GLFWwindow *window);
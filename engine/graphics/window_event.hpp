@@ -0,0 +1,33 @@
+#pragma once
+
+#include "window_config.hpp"
+
+#include <variant>
+
+struct ResizeEvent {
+    int width;
+    int height;
+};
+
+struct CursorEvent {
+    double x;
+    double y;
+};
+
+struct KeyboardEvent {
+    key_value value;
+    key_action action;
+    key_modifier modifier;
+};
+
+struct MouseButtonEvent {
+    mouse_button button;
+    key_action action;
+    key_modifier modifier;
+};
+
+struct MouseScrollEvent {
+    double offset;
+};
+
+using WindowEvent = std::variant<ResizeEvent, CursorEvent, KeyboardEvent, MouseButtonEvent, MouseScrollEvent>;
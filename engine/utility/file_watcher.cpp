@@ -0,0 +1,103 @@
+#include "file_watcher.hpp"
+
+#include "log.hpp"
+#include "trace.hpp"
+
+#include <unordered_map>
+
+#ifdef __linux__
+#include <poll.h>
+#include <sys/inotify.h>
+#include <unistd.h>
+#endif
+
+FileWatcher::FileWatcher(std::filesystem::path directory, std::string extension, changed_t callback, std::chrono::milliseconds interval)
+    : directory_{std::move(directory)}
+    , extension_{std::move(extension)}
+    , callback_{std::move(callback)}
+    , interval_{interval} {
+    thread_ = std::thread{[this]() {
+        trace_thread_name("file watcher");
+        if (!watch_notifications()) {
+            info_println("Poll directory {} for changes", directory_.string());
+            watch_modifications();
+        }
+    }};
+}
+
+FileWatcher::~FileWatcher() {
+    stopping_ = true;
+    thread_.join();
+}
+
+bool FileWatcher::is_watched(std::filesystem::path const &path) const {
+    return extension_.empty() || path.extension() == extension_;
+}
+
+#ifdef __linux__
+
+bool FileWatcher::watch_notifications() {
+    int fd = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+    if (fd < 0) {
+        return false;
+    }
+    // files written in place are reported on close, files replaced by renaming are reported on move
+    if (inotify_add_watch(fd, directory_.c_str(), IN_CLOSE_WRITE | IN_MOVED_TO) < 0) {
+        close(fd);
+        return false;
+    }
+    info_println("Watch directory {} for changes", directory_.string());
+    alignas(inotify_event) char buffer[4096];
+    pollfd poll_fd{.fd = fd, .events = POLLIN};
+    while (!stopping_) {
+        if (poll(&poll_fd, 1, static_cast<int>(interval_.count())) <= 0) {
+            continue;
+        }
+        ssize_t size;
+        while ((size = read(fd, buffer, sizeof(buffer))) > 0) {
+            for (char const *ptr = buffer; ptr < buffer + size;) {
+                auto event = reinterpret_cast<inotify_event const *>(ptr);
+                ptr += sizeof(inotify_event) + event->len;
+                if (event->len == 0) {
+                    continue;
+                }
+                auto path = directory_ / event->name;
+                if (is_watched(path)) {
+                    callback_(path);
+                }
+            }
+        }
+    }
+    close(fd);
+    return true;
+}
+
+#else
+
+bool FileWatcher::watch_notifications() {
+    return false;
+}
+
+#endif
+
+void FileWatcher::watch_modifications() {
+    std::unordered_map<std::string, std::filesystem::file_time_type> write_times;
+    bool initial = true;
+    while (!stopping_) {
+        std::error_code error;
+        for (auto const &entry : std::filesystem::directory_iterator{directory_, error}) {
+            if (!entry.is_regular_file(error) || !is_watched(entry.path())) {
+                continue;
+            }
+            auto write_time = entry.last_write_time(error);
+            auto [iter, inserted] = write_times.try_emplace(entry.path().string(), write_time);
+            // the files found by the first scan are not reported
+            if ((inserted && !initial) || (!inserted && iter->second != write_time)) {
+                iter->second = write_time;
+                callback_(entry.path());
+            }
+        }
+        initial = false;
+        std::this_thread::sleep_for(interval_);
+    }
+}
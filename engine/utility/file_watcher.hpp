@@ -0,0 +1,42 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <filesystem>
+#include <functional>
+#include <string>
+#include <thread>
+
+// notifies about the files of the directory which have been written, the callback is called from the watcher thread
+class FileWatcher {
+  public:
+    using changed_t = std::function<void(std::filesystem::path const &)>;
+
+  private:
+    std::filesystem::path directory_;
+    std::string extension_;
+    changed_t callback_;
+    std::chrono::milliseconds interval_;
+    std::atomic_bool stopping_{false};
+    std::thread thread_;
+
+    bool is_watched(std::filesystem::path const &path) const;
+
+    // returns false if the notifications are not supported
+    bool watch_notifications();
+
+    void watch_modifications();
+
+  public:
+    // empty extension matches all the files, the interval bounds the reaction to the stop and the polling period
+    FileWatcher(std::filesystem::path directory,
+                std::string extension,
+                changed_t callback,
+                std::chrono::milliseconds interval = std::chrono::milliseconds{250});
+
+    FileWatcher(FileWatcher const &) = delete;
+
+    FileWatcher &operator=(FileWatcher const &) = delete;
+
+    ~FileWatcher();
+};
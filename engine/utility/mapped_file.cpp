@@ -0,0 +1,107 @@
+#include "mapped_file.hpp"
+
+#include "error.hpp"
+
+#include <utility>
+
+#ifdef _WIN32
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+#ifdef _WIN32
+
+MappedFile::MappedFile(std::filesystem::path const &path) {
+    HANDLE file = CreateFileW(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        raise_error("Failed to open file {}", path.string());
+    }
+    LARGE_INTEGER size;
+    if (!GetFileSizeEx(file, &size)) {
+        CloseHandle(file);
+        raise_error("Failed to get size of file {}", path.string());
+    }
+    size_ = static_cast<size_t>(size.QuadPart);
+    // empty files can not be mapped
+    if (size_ > 0) {
+        mapping_ = CreateFileMappingW(file, nullptr, PAGE_READONLY, 0, 0, nullptr);
+        if (mapping_ != nullptr) {
+            data_ = static_cast<std::byte const *>(MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0));
+        }
+    }
+    CloseHandle(file);
+    if (size_ > 0 && data_ == nullptr) {
+        unmap();
+        raise_error("Failed to map file {}", path.string());
+    }
+}
+
+void MappedFile::unmap() {
+    if (data_ != nullptr) {
+        UnmapViewOfFile(data_);
+    }
+    if (mapping_ != nullptr) {
+        CloseHandle(mapping_);
+    }
+    data_ = nullptr;
+    mapping_ = nullptr;
+    size_ = 0;
+}
+
+#else
+
+MappedFile::MappedFile(std::filesystem::path const &path) {
+    int file = open(path.c_str(), O_RDONLY);
+    if (file < 0) {
+        raise_error("Failed to open file {}", path.string());
+    }
+    struct stat status;
+    if (fstat(file, &status) != 0) {
+        close(file);
+        raise_error("Failed to get size of file {}", path.string());
+    }
+    size_ = static_cast<size_t>(status.st_size);
+    void *data = size_ > 0 ? mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, file, 0) : nullptr;
+    // the mapping stays valid after the file is closed
+    close(file);
+    if (data == MAP_FAILED) {
+        size_ = 0;
+        raise_error("Failed to map file {}", path.string());
+    }
+    data_ = static_cast<std::byte const *>(data);
+}
+
+void MappedFile::unmap() {
+    if (data_ != nullptr) {
+        munmap(const_cast<std::byte *>(data_), size_);
+    }
+    data_ = nullptr;
+    size_ = 0;
+}
+
+#endif
+
+MappedFile::MappedFile(MappedFile &&other) noexcept {
+    *this = std::move(other);
+}
+
+MappedFile &MappedFile::operator=(MappedFile &&other) noexcept {
+    if (this != &other) {
+        unmap();
+        std::swap(data_, other.data_);
+        std::swap(size_, other.size_);
+#ifdef _WIN32
+        std::swap(mapping_, other.mapping_);
+#endif
+    }
+    return *this;
+}
+
+MappedFile::~MappedFile() {
+    unmap();
+}
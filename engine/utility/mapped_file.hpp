@@ -0,0 +1,39 @@
+#pragma once
+
+#include <cstddef>
+#include <filesystem>
+#include <span>
+
+// read only view of the file mapped to the memory, the data is aligned to the page boundary
+class MappedFile {
+    std::byte const *data_ = nullptr;
+    size_t size_ = 0;
+#ifdef _WIN32
+    void *mapping_ = nullptr;
+#endif
+
+    void unmap();
+
+  public:
+    MappedFile() = default;
+
+    explicit MappedFile(std::filesystem::path const &path);
+
+    MappedFile(MappedFile &&other) noexcept;
+
+    MappedFile &operator=(MappedFile &&other) noexcept;
+
+    MappedFile(MappedFile const &) = delete;
+
+    MappedFile &operator=(MappedFile const &) = delete;
+
+    ~MappedFile();
+
+    std::span<std::byte const> get_data() const {
+        return {data_, size_};
+    }
+
+    size_t get_size() const {
+        return size_;
+    }
+};
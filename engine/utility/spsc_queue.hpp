@@ -0,0 +1,42 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+
+// lock-free ring buffer for a single producer thread and a single consumer thread
+template <typename T, size_t capacity>
+class SpscQueue {
+    static_assert(capacity > 0 && (capacity & (capacity - 1)) == 0, "Capacity must be a power of two.");
+
+    static constexpr size_t mask = capacity - 1;
+
+    std::array<T, capacity> buffer_;
+    alignas(64) std::atomic<size_t> head_{0};
+    alignas(64) std::atomic<size_t> tail_{0};
+
+  public:
+    bool push(T const &value) {
+        size_t tail = tail_.load(std::memory_order_relaxed);
+        if (tail - head_.load(std::memory_order_acquire) == capacity) {
+            return false;
+        }
+        buffer_[tail & mask] = value;
+        tail_.store(tail + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool pop(T &value) {
+        size_t head = head_.load(std::memory_order_relaxed);
+        if (head == tail_.load(std::memory_order_acquire)) {
+            return false;
+        }
+        value = buffer_[head & mask];
+        head_.store(head + 1, std::memory_order_release);
+        return true;
+    }
+
+    bool empty() const {
+        return head_.load(std::memory_order_acquire) == tail_.load(std::memory_order_acquire);
+    }
+};
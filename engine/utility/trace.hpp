@@ -0,0 +1,17 @@
+#pragma once
+
+#include "trace_provider.hpp"
+
+#if defined ENABLE_TRACE
+#define trace_concat_impl(left, right) left##right
+#define trace_concat(left, right) trace_concat_impl(left, right)
+#define trace_zone(name) TraceZone trace_concat(trace_zone_, __LINE__){name}
+#define trace_counter(name, value) TraceProvider::counter(name, static_cast<double>(value))
+#define trace_thread_name(name) TraceProvider::set_thread_name(name)
+#define trace_flush() TraceProvider::flush()
+#else
+#define trace_zone(name)
+#define trace_counter(name, value)
+#define trace_thread_name(name)
+#define trace_flush()
+#endif
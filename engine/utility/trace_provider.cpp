@@ -0,0 +1,206 @@
+#include "trace_provider.hpp"
+
+#include "error.hpp"
+#include "log.hpp"
+#include "spsc_queue.hpp"
+
+#include <chrono>
+#include <cstdint>
+#include <fstream>
+#include <iomanip>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+namespace {
+
+    enum class EventType : uint8_t {
+        begin,
+        end,
+        counter,
+    };
+
+    struct Event {
+        char const *name;
+        // nanoseconds since the trace start
+        uint64_t timestamp;
+        double value;
+        EventType type;
+    };
+
+    constexpr inline size_t buffer_capacity = 1 << 14;
+    // the trace keeps the latest events so a long run does not exhaust the memory
+    constexpr inline size_t max_events_count = 1 << 20;
+
+    // the owning thread produces events and the flushing thread consumes them
+    struct ThreadBuffer {
+        SpscQueue<Event, buffer_capacity> queue;
+        std::atomic<uint64_t> dropped{0};
+        uint32_t thread_id;
+        std::string thread_name;
+    };
+
+    struct RecordedEvent {
+        Event event;
+        uint32_t thread_id;
+    };
+
+    struct TraceContext {
+        std::mutex mutex;
+        // buffers are kept after the threads exit so their events are not lost
+        std::vector<std::shared_ptr<ThreadBuffer>> buffers;
+        // ring of the recorded events, the oldest one is at the next index once the ring is full
+        std::vector<RecordedEvent> events;
+        size_t next_event = 0;
+        uint64_t overwritten = 0;
+        std::atomic_bool enabled{true};
+        std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    };
+
+    TraceContext &get_trace_context() {
+        static TraceContext context;
+        return context;
+    }
+
+    ThreadBuffer &get_thread_buffer() {
+        thread_local std::shared_ptr<ThreadBuffer> buffer = [] {
+            auto &context = get_trace_context();
+            auto buffer = std::make_shared<ThreadBuffer>();
+            std::lock_guard lock{context.mutex};
+            buffer->thread_id = static_cast<uint32_t>(context.buffers.size() + 1);
+            context.buffers.push_back(buffer);
+            return buffer;
+        }();
+        return *buffer;
+    }
+
+    void push_event(char const *name, double value, EventType type) {
+        auto &context = get_trace_context();
+        if (!context.enabled.load(std::memory_order_relaxed)) {
+            return;
+        }
+        auto timestamp = std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now() - context.start);
+        auto &buffer = get_thread_buffer();
+        // the thread never waits for the flushing so the events are dropped when the buffer is full
+        if (!buffer.queue.push(Event{.name = name, .timestamp = static_cast<uint64_t>(timestamp.count()), .value = value, .type = type})) {
+            buffer.dropped.fetch_add(1, std::memory_order_relaxed);
+        }
+    }
+
+    void flush_buffers(TraceContext &context) {
+        Event event;
+        for (auto const &buffer : context.buffers) {
+            while (buffer->queue.pop(event)) {
+                RecordedEvent recorded{.event = event, .thread_id = buffer->thread_id};
+                if (context.events.size() < max_events_count) {
+                    context.events.push_back(recorded);
+                    continue;
+                }
+                if (context.overwritten++ == 0) {
+                    info_println("Trace has reached {} events, the oldest ones are overwritten", max_events_count);
+                }
+                context.events[context.next_event] = recorded;
+                context.next_event = (context.next_event + 1) % max_events_count;
+            }
+        }
+    }
+
+    void write_string(std::ostream &os, std::string_view str) {
+        os << '"';
+        for (char symbol : str) {
+            if (symbol == '"' || symbol == '\\') {
+                os << '\\';
+            }
+            os << symbol;
+        }
+        os << '"';
+    }
+
+    char const *event_type_to_str(EventType type) {
+        switch (type) {
+        case EventType::begin:
+            return "B";
+        case EventType::end:
+            return "E";
+        default:
+            return "C";
+        }
+    }
+
+} // namespace
+
+void TraceProvider::begin_zone(char const *name) {
+    push_event(name, 0.0, EventType::begin);
+}
+
+void TraceProvider::end_zone(char const *name) {
+    push_event(name, 0.0, EventType::end);
+}
+
+void TraceProvider::counter(char const *name, double value) {
+    push_event(name, value, EventType::counter);
+}
+
+void TraceProvider::set_thread_name(std::string_view name) {
+    auto &buffer = get_thread_buffer();
+    std::lock_guard lock{get_trace_context().mutex};
+    buffer.thread_name = name;
+}
+
+void TraceProvider::set_enabled(bool enabled) {
+    get_trace_context().enabled = enabled;
+}
+
+void TraceProvider::flush() {
+    auto &context = get_trace_context();
+    std::lock_guard lock{context.mutex};
+    flush_buffers(context);
+}
+
+void TraceProvider::clear() {
+    auto &context = get_trace_context();
+    std::lock_guard lock{context.mutex};
+    flush_buffers(context);
+    context.events.clear();
+    context.next_event = 0;
+    context.overwritten = 0;
+    for (auto const &buffer : context.buffers) {
+        buffer->dropped = 0;
+    }
+}
+
+void TraceProvider::save_chrome_trace(std::string_view filename) {
+    std::ofstream fout{std::string{filename}};
+    if (!fout.is_open()) {
+        raise_error("Failed to open file {} to write", filename);
+    }
+    auto &context = get_trace_context();
+    std::lock_guard lock{context.mutex};
+    flush_buffers(context);
+    uint64_t dropped = 0;
+    // timestamps are written in microseconds
+    fout << std::fixed << std::setprecision(3) << "{\"traceEvents\":[";
+    char const *separator = "\n";
+    for (auto const &buffer : context.buffers) {
+        dropped += buffer->dropped;
+        if (!buffer->thread_name.empty()) {
+            fout << separator << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << buffer->thread_id << ",\"args\":{\"name\":";
+            write_string(fout, buffer->thread_name);
+            fout << "}}";
+            separator = ",\n";
+        }
+    }
+    for (size_t i = 0; i < context.events.size(); ++i) {
+        auto const &[event, thread_id] = context.events[(context.next_event + i) % context.events.size()];
+        fout << separator << "{\"name\":";
+        write_string(fout, event.name);
+        fout << ",\"ph\":\"" << event_type_to_str(event.type) << "\",\"ts\":" << event.timestamp / 1000.0 << ",\"pid\":1,\"tid\":" << thread_id;
+        if (event.type == EventType::counter) {
+            fout << ",\"args\":{\"value\":" << event.value << '}';
+        }
+        fout << '}';
+        separator = ",\n";
+    }
+    fout << "\n],\"displayTimeUnit\":\"ms\",\"otherData\":{\"dropped_events\":" << dropped << ",\"overwritten_events\":" << context.overwritten << "}}\n";
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string_view>
+
+// collects zones and counters of the threads to the trace which is viewed by chrome://tracing or Perfetto
+class TraceProvider {
+  public:
+    // names have to be string literals since only pointers are recorded
+    static void begin_zone(char const *name);
+
+    static void end_zone(char const *name);
+
+    static void counter(char const *name, double value);
+
+    static void set_thread_name(std::string_view name);
+
+    static void set_enabled(bool enabled);
+
+    // moves the events from the buffers of the threads to the trace, may be called from any thread
+    static void flush();
+
+    static void clear();
+
+    static void save_chrome_trace(std::string_view filename);
+};
+
+// ends the zone when leaves the scope
+class TraceZone {
+    char const *name_;
+
+  public:
+    explicit TraceZone(char const *name)
+        : name_{name} {
+        TraceProvider::begin_zone(name_);
+    }
+
+    TraceZone(TraceZone const &) = delete;
+    TraceZone &operator=(TraceZone const &) = delete;
+
+    ~TraceZone() {
+        TraceProvider::end_zone(name_);
+    }
+};
@@ -14,12 +14,16 @@ int main() {
         auto const &device = renderer.get_device_context();
         PipelineProvider provider(device.get_device(),
                                   device.get_physical_device(),
+                                  device.get_pipeline_cache(),
                                   device.get_transfer_qfm(),
                                   device.get_graphics_qfm(),
-                                  renderer.get_allocator());
+                                  renderer.get_allocator(),
+                                  renderer.get_deleter(),
+                                  renderer.get_layout_cache(),
+                                  renderer.get_descriptor_allocator());
         renderer.set_context_changed_callback(std::bind(&PipelineProvider::setup_pipeline, &provider, _1));
         renderer.set_update_command_callback(std::bind(&PipelineProvider::update_command_buffer, &provider, _1, _2));
-        renderer.set_update_frame_callback(std::bind(&PipelineProvider::update_image, &provider, _1));
+        renderer.set_update_frame_callback(std::bind(&PipelineProvider::update_image, &provider, _1, _2));
         renderer.run();
     } catch (const std::exception &ex) {
         error_println("{}", ex.what());
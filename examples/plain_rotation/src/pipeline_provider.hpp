@@ -6,6 +6,7 @@
 
 #include "graphics/allocator_interface.hpp"
 #include "graphics/commander.hpp"
+#include "graphics/deferred_deleter.hpp"
 #include "graphics/descriptor_set.hpp"
 #include "graphics/graphics_renderer.hpp"
 #include "graphics/pipeline_builder.hpp"
@@ -13,28 +14,36 @@
 
 class PipelineProvider {
     std::shared_ptr<AllocatorInterface> allocator_;
+    std::shared_ptr<DeferredDeleter> deleter_;
     Commander transfer_;
     Commander barrier_;
     PlainMesh mesh_;
     std::shared_ptr<TextureDescriptor> texture_;
     std::shared_ptr<MatrixDescriptor> matrix_;
-    DescriptorSet descriptor_set_;
-    PipelineBuilder builder_;
     ShaderContext vertex_shader_;
     ShaderContext fragment_shader_;
+    // the descriptor set and the pipeline layouts are reflected from the shaders
+    ShaderLayout shader_layout_;
+    DescriptorSet descriptor_set_;
+    PipelineBuilder builder_;
     shared_ptr_of<VkPipelineLayout> pipeline_layout_;
     unique_ptr_of<VkPipeline> pipeline_;
+    VkRenderPass render_pass_ = nullptr;
 
   public:
     PipelineProvider(shared_ptr_of<VkDevice> device,
                      VkPhysicalDevice phys_device,
+                     VkPipelineCache pipeline_cache,
                      uint32_t transfer_qfm,
                      uint32_t graphics_qfm,
-                     std::shared_ptr<AllocatorInterface> allocator);
+                     std::shared_ptr<AllocatorInterface> allocator,
+                     std::shared_ptr<DeferredDeleter> deleter,
+                     LayoutCache &layout_cache,
+                     std::shared_ptr<DescriptorAllocator> descriptor_allocator);
 
     void update_command_buffer(VkCommandBuffer command_buffer, size_t image_index);
 
     void setup_pipeline(GraphicsRenderer::Context const &info);
 
-    void update_image(size_t image_index);
+    void update_image(size_t frame_index, size_t image_index);
 };
\ No newline at end of file
@@ -87,12 +87,12 @@ PlainMesh::PlainMesh(shared_ptr_of<VkDevice> device, std::shared_ptr<AllocatorIn
     transfer.execute();
 }
 
-void PlainMesh::draw(VkCommandBuffer command_buffer) const {
+void PlainMesh::draw(VkCommandBuffer command_buffer, uint32_t instances_count, uint32_t first_instance) const {
     VkBuffer vertex_buffer = vertex_buffer_.get_buffer();
     VkDeviceSize offset = 0;
     vkCmdBindVertexBuffers(command_buffer, 0, 1, &vertex_buffer, &offset);
     vkCmdBindIndexBuffer(command_buffer, index_buffer_.get_buffer(), 0, VK_INDEX_TYPE_UINT16);
-    vkCmdDrawIndexed(command_buffer, static_cast<uint32_t>(mesh_.get_index_count()), 1, 0, 0, 0);
+    vkCmdDrawIndexed(command_buffer, static_cast<uint32_t>(mesh_.get_index_count()), instances_count, 0, 0, first_instance);
 }
 
 VkVertexInputBindingDescription PlainMesh::get_vertex_binding_description() const {
@@ -22,7 +22,7 @@ class PlainMesh {
   public:
     PlainMesh(shared_ptr_of<VkDevice> device, std::shared_ptr<AllocatorInterface> allocator, Commander &transfer);
 
-    void draw(VkCommandBuffer command_buffer) const;
+    void draw(VkCommandBuffer command_buffer, uint32_t instances_count = 1, uint32_t first_instance = 0) const;
 
     VkVertexInputBindingDescription get_vertex_binding_description() const;
 
@@ -1,5 +1,7 @@
 #version 450
 
+layout (constant_id = 0) const bool monochrome = false;
+
 layout (location = 0) out vec3 color;
 
 const vec2 points[3] = vec2[] (
@@ -16,5 +18,5 @@ const vec3 colors[3] = vec3[] (
 
 void main() {
     gl_Position = vec4(points[gl_VertexIndex], 0, 1);
-    color = colors[gl_VertexIndex];
+    color = monochrome ? vec3(1, 1, 1) : colors[gl_VertexIndex];
 }
\ No newline at end of file
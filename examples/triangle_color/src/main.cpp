@@ -7,21 +7,28 @@
 int main() {
     using namespace std::placeholders;
     try {
+        // the scene is static so frames are rendered only on changes
         GraphicsRenderer renderer{WindowConfig{
-            .title = "Hardcoded triangle application",
-            .width = 600,
-            .height = 600,
-        }};
-        auto device = renderer.get_device_context().get_device();
-        PipelineProvider provider(device);
+                                      .title = "Hardcoded triangle application",
+                                      .width = 600,
+                                      .height = 600,
+                                  },
+                                  GraphicsRenderer::Config{.render_on_demand = true, .shader_directory = "."}};
+        auto const &device_context = renderer.get_device_context();
+        PipelineProvider provider(device_context.get_device(),
+                                  device_context.get_pipeline_cache(),
+                                  renderer.get_deleter(),
+                                  renderer.get_pipeline_compiler(),
+                                  renderer.get_shader_library());
         renderer.set_keyboard_callback([&provider, &renderer](key_value value, key_action action, key_modifier modifier) {
             if (value == key_value::key_space && action == key_action::release) {
                 provider.change_pipeline();
-                renderer.update_render_pass();
+                renderer.update_commands();
             }
         });
         renderer.set_context_changed_callback(std::bind(&PipelineProvider::setup_pipeline, &provider, _1));
         renderer.set_update_command_callback(std::bind(&PipelineProvider::update_command_buffer, &provider, _1, _2));
+        renderer.set_shaders_reloaded_callback([&provider, &renderer]() { provider.reload_shaders(renderer.get_shader_library()); });
         renderer.run();
 
     } catch (const std::exception &ex) {
@@ -1,8 +1,13 @@
 #include "pipeline_provider.hpp"
 
-PipelineProvider::PipelineProvider(shared_ptr_of<VkDevice> device)
-    : colorful_triangle_{device, "colorful_triangle.vert.spv", "colorful_triangle.frag.spv"}
-    , monochrome_triangle_{device, "monochrome_triangle.vert.spv", "monochrome_triangle.frag.spv"}
+PipelineProvider::PipelineProvider(shared_ptr_of<VkDevice> device,
+                                   VkPipelineCache pipeline_cache,
+                                   std::shared_ptr<DeferredDeleter> deleter,
+                                   PipelineCompiler &compiler,
+                                   ShaderLibrary &library)
+    // both pipelines are compiled in parallel
+    : colorful_triangle_{device, pipeline_cache, deleter, compiler, library, false}
+    , monochrome_triangle_{device, pipeline_cache, deleter, compiler, library, true}
     , current_triangle_{&monochrome_triangle_} {
 }
 
@@ -15,6 +20,11 @@ void PipelineProvider::setup_pipeline(GraphicsRenderer::Context const &info) {
     monochrome_triangle_.update_pipeline(info);
 }
 
+void PipelineProvider::reload_shaders(ShaderLibrary &library) {
+    colorful_triangle_.reload_shaders(library);
+    monochrome_triangle_.reload_shaders(library);
+}
+
 void PipelineProvider::change_pipeline() {
     if (current_triangle_ == &monochrome_triangle_) {
         current_triangle_ = &colorful_triangle_;
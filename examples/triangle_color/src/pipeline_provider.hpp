@@ -8,11 +8,17 @@ class PipelineProvider {
     TrianglePipeline *current_triangle_ = nullptr;
 
   public:
-    explicit PipelineProvider(shared_ptr_of<VkDevice> device);
+    PipelineProvider(shared_ptr_of<VkDevice> device,
+                     VkPipelineCache pipeline_cache,
+                     std::shared_ptr<DeferredDeleter> deleter,
+                     PipelineCompiler &compiler,
+                     ShaderLibrary &library);
 
     void update_command_buffer(VkCommandBuffer command_buffer, size_t index);
 
     void setup_pipeline(GraphicsRenderer::Context const &info);
 
     void change_pipeline();
+
+    void reload_shaders(ShaderLibrary &library);
 };
\ No newline at end of file
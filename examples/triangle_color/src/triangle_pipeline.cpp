@@ -1,34 +1,73 @@
 #include "triangle_pipeline.hpp"
 
 #include "graphics/graphics_manager.hpp"
+#include "utility/log.hpp"
 
-TrianglePipeline::TrianglePipeline(shared_ptr_of<VkDevice> device, std::string_view vertex_shader, std::string_view fragment_shader)
-    : vertex_shader_{device, vertex_shader, VK_SHADER_STAGE_VERTEX_BIT}
-    , fragment_shader_{device, fragment_shader, VK_SHADER_STAGE_FRAGMENT_BIT}
-    , pipeline_builder_{device} {
-    pipeline_builder_.set_shader_stages({vertex_shader_.get_shader_stage(), fragment_shader_.get_shader_stage()});
+#include <exception>
+#include <utility>
+
+namespace {
+
+    char const *const vertex_shader_file = "triangle.vert.spv";
+    char const *const fragment_shader_file = "triangle.frag.spv";
+
+} // namespace
+
+TrianglePipeline::TrianglePipeline(shared_ptr_of<VkDevice> device,
+                                   VkPipelineCache pipeline_cache,
+                                   std::shared_ptr<DeferredDeleter> deleter,
+                                   PipelineCompiler &compiler,
+                                   ShaderLibrary &library,
+                                   bool monochrome)
+    : deleter_{deleter}
+    , compiler_{compiler}
+    , constants_{TriangleConstants::make(monochrome)}
+    , vertex_shader_{library.get_shader(vertex_shader_file, VK_SHADER_STAGE_VERTEX_BIT).specialize(constants_)}
+    , fragment_shader_{library.get_shader(fragment_shader_file, VK_SHADER_STAGE_FRAGMENT_BIT)}
+    , pipeline_builder_{device, pipeline_cache} {
+    pipeline_builder_.set_shader_stages({&vertex_shader_, &fragment_shader_});
     pipeline_builder_.set_pipeline_layout(GraphicsManager::make_pipeline_layout(device, {}, {}));
 }
 
 void TrianglePipeline::update_pipeline(GraphicsRenderer::Context const &context) {
-    VkViewport viewport{
-        .x = 0,
-        .y = 0,
-        .width = static_cast<float>(context.surface_extent.width),
-        .height = static_cast<float>(context.surface_extent.height),
-        .minDepth = 0,
-        .maxDepth = 1,
-    };
-    VkRect2D scissor{.offset = {.x = 0, .y = 0}, .extent = context.surface_extent};
-    ViewportStateProvider viewport_provider;
-    viewport_provider.set_viewports({viewport});
-    viewport_provider.set_scissors({scissor});
-    pipeline_builder_.set_viewport_state(std::move(viewport_provider));
-    pipeline_builder_.set_render_pass(context.render_pass);
-    pipeline_ = pipeline_builder_.make_pipeline();
+    // viewport and scissor are dynamic so the pipeline is rebuilt only for a new render pass
+    if (pipeline_.is_valid() && render_pass_ == context.render_pass) {
+        return;
+    }
+    render_pass_ = context.render_pass;
+    pipeline_builder_.set_render_pass(context.render_pass, context.render_pass_key);
+    // the previous pipeline may be still used by the frames in flight
+    deleter_->retire(std::move(pipeline_));
+    pipeline_ = compiler_.compile(pipeline_builder_);
+    pending_pipeline_ = {};
+}
+
+void TrianglePipeline::reload_shaders(ShaderLibrary &library) {
+    vertex_shader_ = library.get_shader(vertex_shader_file, VK_SHADER_STAGE_VERTEX_BIT).specialize(constants_);
+    fragment_shader_ = library.get_shader(fragment_shader_file, VK_SHADER_STAGE_FRAGMENT_BIT);
+    pipeline_builder_.set_shader_stages({&vertex_shader_, &fragment_shader_});
+    if (render_pass_ != nullptr) {
+        // the current pipeline is drawn until the new one is compiled
+        pending_pipeline_ = compiler_.compile(pipeline_builder_);
+    }
 }
 
 void TrianglePipeline::draw(VkCommandBuffer command_buffer) {
-    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline_.get());
+    // the commands are recorded at the frame boundary so the pipelines are swapped there
+    if (pending_pipeline_.is_ready()) {
+        try {
+            pending_pipeline_.get();
+            deleter_->retire(std::exchange(pipeline_, pending_pipeline_));
+        } catch (std::exception const &ex) {
+            error_println("Failed to compile the reloaded pipeline: {}", ex.what());
+        }
+        pending_pipeline_ = {};
+    }
+    // nothing is drawn until the pipeline is compiled, the commands are recorded again after that
+    VkPipeline pipeline = pipeline_.get();
+    if (pipeline == nullptr) {
+        return;
+    }
+    vkCmdBindPipeline(command_buffer, VK_PIPELINE_BIND_POINT_GRAPHICS, pipeline);
     vkCmdDraw(command_buffer, 3, 1, 0, 0);
 }
@@ -1,22 +1,41 @@
 #pragma once
 
+#include "graphics/deferred_deleter.hpp"
 #include "graphics/graphics_types.hpp"
 #include "graphics/pipeline_builder.hpp"
+#include "graphics/pipeline_compiler.hpp"
 #include "graphics/shader_context.hpp"
+#include "graphics/shader_library.hpp"
 #include "graphics/graphics_renderer.hpp"
 
 #include <vector>
 
+// both triangles are drawn by the same shaders specialized by the constant
+using TriangleConstants = SpecializationLayout<SpecializationConstant<0, bool>>;
+
 class TrianglePipeline {
-    unique_ptr_of<VkPipeline> pipeline_;
+    std::shared_ptr<DeferredDeleter> deleter_;
+    PipelineCompiler &compiler_;
+    PipelineCompiler::Handle pipeline_;
+    // pipeline of the reloaded shaders which replaces the current one when compiled
+    PipelineCompiler::Handle pending_pipeline_;
+    VkRenderPass render_pass_ = nullptr;
+    SpecializationConstants constants_;
     ShaderContext vertex_shader_;
     ShaderContext fragment_shader_;
     PipelineBuilder pipeline_builder_;
 
   public:
-    TrianglePipeline(shared_ptr_of<VkDevice> device, std::string_view vertex_shader, std::string_view fragment_shader);
+    TrianglePipeline(shared_ptr_of<VkDevice> device,
+                     VkPipelineCache pipeline_cache,
+                     std::shared_ptr<DeferredDeleter> deleter,
+                     PipelineCompiler &compiler,
+                     ShaderLibrary &library,
+                     bool monochrome);
 
     void update_pipeline(GraphicsRenderer::Context const &context);
 
+    void reload_shaders(ShaderLibrary &library);
+
     void draw(VkCommandBuffer command_buffer);
 };
\ No newline at end of file
@@ -1,9 +1,9 @@
-file(GLOB shaders ${INPUT_DIR}/*.vert ${INPUT_DIR}/*.frag)
+file(GLOB shaders ${INPUT_DIR}/*.vert ${INPUT_DIR}/*.frag ${INPUT_DIR}/*.comp)
 message(STATUS "output directory ${OUTPUT_DIR}")
 foreach (shader ${shaders})
     get_filename_component(shader_name ${shader} NAME)
     message(STATUS "compiling ${shader_name}")
-    execute_process(COMMAND glslc.exe ${shader} -o ${OUTPUT_DIR}/${shader_name}.spv)
+    execute_process(COMMAND ${GLSLC} ${shader} -o ${OUTPUT_DIR}/${shader_name}.spv)
 endforeach()
 ## because visual studio projects create additional Debug and Release folders in binary directory
 if (EXISTS ${OUTPUT_DIR}/Debug)
@@ -0,0 +1,45 @@
+## compiles the shaders and writes their SPIR-V words to the header so the modules are created without reading files
+file(GLOB shaders ${INPUT_DIR}/*.vert ${INPUT_DIR}/*.frag ${INPUT_DIR}/*.comp)
+get_filename_component(output_dir ${OUTPUT_FILE} DIRECTORY)
+file(MAKE_DIRECTORY ${output_dir})
+set(content "#pragma once\n\n// generated by embed_shaders.cmake, do not edit\n\n#include <cstdint>\n\nnamespace embedded_shaders {\n")
+foreach (shader ${shaders})
+    get_filename_component(shader_name ${shader} NAME)
+    set(spirv_file ${output_dir}/${shader_name}.spv)
+    message(STATUS "embedding ${shader_name}")
+    execute_process(COMMAND ${GLSLC} ${shader} -o ${spirv_file} RESULT_VARIABLE result)
+    if (NOT result EQUAL 0)
+        message(FATAL_ERROR "failed to compile ${shader_name}")
+    endif()
+    if (SPIRV_OPT)
+        execute_process(COMMAND ${SPIRV_OPT} -O ${spirv_file} -o ${spirv_file}.opt RESULT_VARIABLE result)
+        if (result EQUAL 0)
+            file(RENAME ${spirv_file}.opt ${spirv_file})
+        else()
+            message(STATUS "failed to optimize ${shader_name}, the unoptimized code is embedded")
+        endif()
+    endif()
+    file(READ ${spirv_file} bytes HEX)
+    string(LENGTH "${bytes}" length)
+    math(EXPR remainder "${length} % 8")
+    if (NOT remainder EQUAL 0)
+        message(FATAL_ERROR "${shader_name} is not a sequence of SPIR-V words")
+    endif()
+    ## SPIR-V words are little endian
+    string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1, " words "${bytes}")
+    ## cmake regular expressions have no repetition counts so a line of 8 words is spelled out
+    set(word "0x[0-9a-f]+, ")
+    string(REGEX REPLACE "(${word}${word}${word}${word}${word}${word}${word}${word})" "\\1\n        " words "${words}")
+    string(REPLACE " \n" "\n" words "${words}")
+    string(REGEX REPLACE "[ \n]+$" "" words "${words}")
+    string(MAKE_C_IDENTIFIER ${shader_name} identifier)
+    string(APPEND content "\n    alignas(uint32_t) inline constexpr uint32_t ${identifier}[] = {\n        ${words}\n    };\n")
+endforeach()
+string(APPEND content "\n} // namespace embedded_shaders\n")
+## the header is not touched if nothing has changed so the dependent sources are not rebuilt
+if (EXISTS ${OUTPUT_FILE})
+    file(READ ${OUTPUT_FILE} old_content)
+endif()
+if (NOT "${content}" STREQUAL "${old_content}")
+    file(WRITE ${OUTPUT_FILE} "${content}")
+endif()